@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FuzzTargets.hpp"
+
+#include <FileContent.hpp>
+#include <formatter/Formatter.hpp>
+#include <formatter/TextEdits.hpp>
+#include <formatter/detail/FormatLine.hpp>
+#include <formatter/detail/InsertNewLineAfterChar.hpp>
+#include <formatter/detail/SplitLine.hpp>
+#include <formatter/detail/UpdateIndentation.hpp>
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+#include <io/InputNormalizer.hpp>
+#include <memory/CountingResource.hpp>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <set>
+#include <string>
+
+
+namespace fuzz
+{
+
+namespace
+{
+
+constexpr int max_num_of_spaces = 8;
+constexpr std::size_t max_keyword_length = 7;
+
+
+struct FuzzInput
+{
+    formatter::FormatterOptions options;
+    std::string_view text;
+};
+
+
+FuzzInput
+decodeInput(const std::uint8_t *data, const std::size_t size)
+{
+    FuzzInput input;
+    auto &indentation = input.options.indentation;
+    auto &split = input.options.split;
+
+    std::size_t pos = 0;
+    const auto next = [&]() -> std::uint8_t {
+        return pos < size ? data[pos++] : 0;
+    };
+
+    const auto flags = next();
+    indentation.reduce_indent_for_last_decrease_char = flags & 0x01;
+    indentation.progressive_indent = flags & 0x02;
+    split.keep_trailing_delimiter = flags & 0x04;
+    split.keep_delimiter_runs = flags & 0x08;
+    indentation.num_of_spaces = (flags >> 4) % (max_num_of_spaces + 1);
+
+    const auto counts = next();
+    split.split_after_chars.clear();
+    int shift = 0;
+    for (auto *chars : {&indentation.increase_indentation_chars, &indentation.decrease_indentation_chars,
+                        &split.split_after_chars, &split.split_before_chars}) {
+        for (int i = 0; i < ((counts >> shift) & 0x03) and pos < size; ++i) {
+            const auto c = static_cast<char>(next());
+            if (not is_white_char(c) and c != '\n') {
+                chars->insert(c);
+            }
+        }
+        shift += 2;
+    }
+
+    const auto keyword_counts = next();
+    shift = 0;
+    for (auto *keywords : {&indentation.increase_indentation_keywords, &indentation.decrease_indentation_keywords}) {
+        for (int i = 0; i < ((keyword_counts >> shift) & 0x03) and pos < size; ++i) {
+            const auto length = std::min<std::size_t>(next() % (max_keyword_length + 1), size - pos);
+            const std::string keyword(reinterpret_cast<const char*>(data) + pos, length);
+            pos += length;
+
+            const bool has_white_char = std::any_of(keyword.cbegin(), keyword.cend(), [](const char c) {
+                return is_white_char(c) or c == '\n';
+            });
+            if (not keyword.empty() and not has_white_char) {
+                keywords->push_back(keyword);
+            }
+        }
+        shift += 2;
+    }
+
+    input.text = std::string_view(reinterpret_cast<const char*>(data) + pos, size - pos);
+    return input;
+}
+
+
+/*
+ * Measures the work of a pass from its construction. Only the allocations
+ * of the document's resource are counted, all the passes allocate from it.
+ */
+class Measurement
+{
+public:
+    explicit Measurement(memory::CountingResource &resource)
+        : resource_(resource)
+    {
+        resource_.resetStatistics();
+        begin_ = std::chrono::steady_clock::now();
+    }
+
+    void check(const char *pass, const std::size_t processed_bytes, const Limits &limits) const
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - begin_;
+        const auto allocations = resource_.statistics().allocations;
+
+        if (limits.check_time and elapsed > limits.base_time + limits.time_per_byte * processed_bytes) {
+            throw Violation(std::string(pass) + " took "
+                            + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count())
+                            + " us for " + std::to_string(processed_bytes) + " bytes");
+        }
+        if (allocations > limits.base_allocations + limits.allocations_per_byte * processed_bytes) {
+            throw Violation(std::string(pass) + " made " + std::to_string(allocations)
+                            + " allocations for " + std::to_string(processed_bytes) + " bytes");
+        }
+    }
+
+private:
+    memory::CountingResource &resource_;
+    std::chrono::steady_clock::time_point begin_;
+};
+
+
+std::size_t
+contentSize(const FileContent &content)
+{
+    std::size_t size = 0;
+    for (const auto &line : content) {
+        size += line.size() + 1;
+    }
+
+    return size;
+}
+
+
+std::string
+joinedText(const FileContent &content)
+{
+    std::string text;
+    for (const auto &line : content) {
+        text += line;
+    }
+
+    return text;
+}
+
+
+std::string_view
+withoutIndentation(const std::string_view line)
+{
+    const auto content_begin = std::find_if_not(line.cbegin(), line.cend(), is_white_char);
+    return line.substr(static_cast<std::size_t>(content_begin - line.cbegin()));
+}
+
+
+/*
+ * Splitting only moves the text between lines.
+ */
+void
+checkSplit(const char *pass, const FileContent &original, const FileContent &content)
+{
+    if (content.size() < original.size()) {
+        throw Violation(std::string(pass) + " removed lines");
+    }
+    if (joinedText(content) != joinedText(original)) {
+        throw Violation(std::string(pass) + " changed the text");
+    }
+}
+
+
+void
+checkEqual(const char *what, const FileContent &lhs, const FileContent &rhs)
+{
+    if (not std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend())) {
+        throw Violation(std::string(what) + " differ");
+    }
+}
+
+}
+
+
+void
+fuzzSplitLines(const std::uint8_t *data, const std::size_t size, const Limits &limits)
+{
+    const auto input = decodeInput(data, size);
+    memory::CountingResource resource;
+    auto content = io::splitLines(input.text, &resource);
+    const FileContent original(content);
+
+    const Measurement measurement(resource);
+    formatter::detail::splitLines(content, input.options.split);
+    measurement.check("splitLines", input.text.size() + contentSize(content), limits);
+
+    checkSplit("splitLines", original, content);
+}
+
+
+void
+fuzzUpdateIndentation(const std::uint8_t *data, const std::size_t size, const Limits &limits)
+{
+    const auto input = decodeInput(data, size);
+    const auto &options = input.options.indentation;
+    memory::CountingResource resource;
+    auto content = io::splitLines(input.text, &resource);
+    const FileContent original(content);
+
+    const Measurement measurement(resource);
+    formatter::detail::updateIndentation(content, options);
+    measurement.check("updateIndentation", input.text.size() + contentSize(content), limits);
+
+    if (content.size() != original.size()) {
+        throw Violation("updateIndentation changed the number of lines");
+    }
+    for (auto line = content.cbegin(), original_line = original.cbegin(); line != content.cend(); ++line, ++original_line) {
+        const auto text = withoutIndentation(*line);
+        if (text != withoutIndentation(*original_line)) {
+            throw Violation("updateIndentation changed the text of a line");
+        }
+
+        const auto indentation_size = line->size() - text.size();
+        if (text.empty() ? not line->empty()
+                         : (line->find_first_not_of(' ') != indentation_size
+                            or (options.num_of_spaces > 0 and indentation_size % options.num_of_spaces != 0))) {
+            throw Violation("updateIndentation produced an invalid indentation");
+        }
+    }
+}
+
+
+void
+fuzzInsertNewLineAfterChar(const std::uint8_t *data, const std::size_t size, const Limits &limits)
+{
+    const auto input = decodeInput(data, size);
+    const auto &split_chars = input.options.split.split_after_chars;
+    const char character = split_chars.empty() ? ';' : *split_chars.cbegin();
+    memory::CountingResource resource;
+    auto content = io::splitLines(input.text, &resource);
+    const FileContent original(content);
+
+    const Measurement measurement(resource);
+    formatter::detail::insertNewLineAfterChar(content, character);
+    measurement.check("insertNewLineAfterChar", input.text.size() + contentSize(content), limits);
+
+    checkSplit("insertNewLineAfterChar", original, content);
+}
+
+
+/*
+ * The in place pass and the line by line one used by the streaming
+ * formatters have to give the same lines.
+ */
+void
+fuzzFormatLines(const std::uint8_t *data, const std::size_t size, const Limits &limits)
+{
+    const auto input = decodeInput(data, size);
+    const formatter::detail::Splitter splitter(input.options.split);
+    memory::CountingResource resource;
+    auto content = io::splitLines(input.text, &resource);
+    const FileContent original(content);
+
+    {
+        formatter::detail::Indenter indenter(input.options.indentation, &resource);
+        const Measurement measurement(resource);
+        formatter::detail::formatLines(content, splitter, indenter);
+        measurement.check("formatLines", input.text.size() + contentSize(content), limits);
+    }
+
+    formatter::detail::Indenter indenter(input.options.indentation);
+    FileContent formatted_line_by_line;
+    for (const auto &line : original) {
+        formatter::detail::formatLine(line, splitter, indenter, formatted_line_by_line);
+    }
+
+    checkEqual("formatLines and formatLine results", content, formatted_line_by_line);
+}
+
+
+/*
+ * Formatting the output again must not change it. The partial formatting
+ * of all the lines and the text edits have to give the same output.
+ */
+void
+fuzzFormat(const std::uint8_t *data, const std::size_t size, const Limits &limits)
+{
+    const auto input = decodeInput(data, size);
+
+    io::NormalizedInput normalized;
+    try {
+        normalized = io::normalizeInput(input.text);
+    }
+    catch (const io::InvalidInputError &) {
+        return;
+    }
+
+    memory::CountingResource resource;
+    auto content = io::splitLines(normalized.text, &resource);
+
+    const Measurement measurement(resource);
+    formatter::format(content, input.options);
+    measurement.check("format", input.text.size() + contentSize(content), limits);
+
+    std::string formatted;
+    io::writeContent(formatted, content, normalized.format);
+
+    auto partially_formatted = io::splitLines(normalized.text);
+    formatter::format(partially_formatted, input.options, {LineRange {1, partially_formatted.size()}});
+    checkEqual("format of the whole content and of all its lines", content, partially_formatted);
+
+    if (formatter::applyEdits(input.text, formatter::formatEdits(input.text, input.options)) != formatted) {
+        throw Violation("the text edits do not give the formatted text");
+    }
+
+    const auto renormalized = io::normalizeInput(formatted);
+    auto reformatted_content = io::splitLines(renormalized.text);
+    formatter::format(reformatted_content, input.options);
+    std::string reformatted;
+    io::writeContent(reformatted, reformatted_content, renormalized.format);
+
+    if (reformatted != formatted) {
+        throw Violation("format is not idempotent");
+    }
+}
+
+
+Target
+findTarget(const std::string_view name)
+{
+    for (const auto &target : targets) {
+        if (target.name == name) {
+            return target.target;
+        }
+    }
+
+    return nullptr;
+}
+
+}
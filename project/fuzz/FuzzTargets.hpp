@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+
+namespace fuzz
+{
+
+/*
+ * Thrown when an input breaks an invariant of the pass or needs more work
+ * than the limits allow.
+ */
+class Violation : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/*
+ * Work allowed per processed byte, i.e. the input and the output, as
+ * the output of deeply nested input legitimately grows faster than it.
+ * The constant parts cover the fixed costs of small inputs. The time
+ * depends on the machine, the replays on every build check only the
+ * allocations.
+ */
+struct Limits
+{
+    bool check_time {true};
+    std::chrono::microseconds base_time {20000};
+    std::chrono::nanoseconds time_per_byte {2000};
+    std::size_t base_allocations {64};
+    std::size_t allocations_per_byte {4};
+};
+
+/*
+ * The input starts with the formatter options, the rest is the text:
+ *
+ *   byte 0  bit 0 reduce_indent_for_last_decrease_char, bit 1 progressive_indent,
+ *           bit 2 keep_trailing_delimiter, bit 3 keep_delimiter_runs,
+ *           bits 4-7 num_of_spaces (modulo 9)
+ *   byte 1  two bits each for the number of the increase, decrease,
+ *           split-after and split-before chars, from the lowest bits
+ *   then    the chars of the sets, in the same order
+ *   byte    two bits each for the number of the increase and decrease
+ *           keywords, from the lowest bits
+ *   then    the keywords, in the same order, each a length byte (modulo 8)
+ *           followed by its chars
+ *
+ * The white chars and the line break are skipped, the keywords containing
+ * them are dropped, the config files can not set them. Missing bytes leave
+ * the options empty.
+ */
+using Target = void (*)(const std::uint8_t *data, std::size_t size, const Limits &limits);
+
+void fuzzSplitLines(const std::uint8_t *data, std::size_t size, const Limits &limits);
+void fuzzUpdateIndentation(const std::uint8_t *data, std::size_t size, const Limits &limits);
+void fuzzInsertNewLineAfterChar(const std::uint8_t *data, std::size_t size, const Limits &limits);
+void fuzzFormatLines(const std::uint8_t *data, std::size_t size, const Limits &limits);
+void fuzzFormat(const std::uint8_t *data, std::size_t size, const Limits &limits);
+
+struct NamedTarget
+{
+    std::string_view name;
+    Target target;
+};
+
+/*
+ * The targets by the names used for the fuzzer executables. The
+ * regression corpus is shared, every target replays all its inputs.
+ */
+constexpr NamedTarget targets[] = {
+    {"format", fuzzFormat},
+    {"format-lines", fuzzFormatLines},
+    {"insert-new-line-after-char", fuzzInsertNewLineAfterChar},
+    {"split-lines", fuzzSplitLines},
+    {"update-indentation", fuzzUpdateIndentation},
+};
+
+Target findTarget(std::string_view name);
+
+}
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "FuzzTargets.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+
+/*
+ * Every fuzzer executable is built from this file, FUZZ_TARGET_NAME
+ * selects its target. A violation aborts, so the fuzzer saves the input.
+ */
+extern "C" int
+LLVMFuzzerTestOneInput(const std::uint8_t *data, const std::size_t size)
+{
+    static const auto target = fuzz::findTarget(FUZZ_TARGET_NAME);
+
+    try {
+        target(data, size, fuzz::Limits {});
+    }
+    catch (const fuzz::Violation &e) {
+        std::cerr << FUZZ_TARGET_NAME << ": " << e.what() << '\n';
+        std::abort();
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size);
+
+
+/*
+ * Stands in for libFuzzer when the compiler does not provide it: runs
+ * the target once on every file given, directories are read recursively.
+ * Options in the libFuzzer style are ignored.
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<std::filesystem::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::filesystem::path path(argv[i]);
+        if (argv[i][0] == '-') {
+            continue;
+        }
+        if (std::filesystem::is_directory(path)) {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(path)) {
+                if (entry.is_regular_file()) {
+                    inputs.push_back(entry.path());
+                }
+            }
+        }
+        else {
+            inputs.push_back(path);
+        }
+    }
+    std::sort(inputs.begin(), inputs.end());
+
+    for (const auto &input : inputs) {
+        std::ifstream file(input, std::ios::binary);
+        if (not file) {
+            std::cerr << input.string() << ": error: can not open the file\n";
+            return 1;
+        }
+        const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(data.data()), data.size());
+    }
+
+    std::cerr << "replayed " << inputs.size() << " inputs\n";
+    return 0;
+}
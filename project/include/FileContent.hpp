@@ -8,11 +8,32 @@
 
 #pragma once
 
-#include <string>
+#include <cstddef>
 #include <list>
+#include <memory_resource>
+#include <string>
+
+/*
+ * The document types take polymorphic allocators, so a whole file can be
+ * formatted inside a single arena (see memory::Arena).
+ */
+using Line = std::pmr::string;
+using FileContent = std::pmr::list<Line>;
 
-using Line = std::string;
-using FileContent = std::list<Line>;
+/*
+ * Range of line numbers, one-based and inclusive.
+ */
+struct LineRange
+{
+    std::size_t first {0};
+    std::size_t last {0};
+};
+
+inline bool operator==(const LineRange &lhs, const LineRange &rhs)
+{
+    return lhs.first == rhs.first
+        and lhs.last == rhs.last;
+}
 
 
 inline bool is_white_char(const char c)
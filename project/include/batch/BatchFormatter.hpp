@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "batch/Executor.hpp"
+#include "formatter/FormatStatistics.hpp"
+#include "formatter/FormatterOptions.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace batch
+{
+
+struct ItemResult
+{
+    enum class Status
+    {
+        Formatted,
+        InvalidInput,
+        BudgetExceeded,
+        Failed,
+    };
+
+    Status status {Status::Failed};
+    std::string output;
+    std::string error;
+    formatter::FormatStatistics statistics;
+};
+
+/*
+ * Formats every buffer with the same options, keeping its BOM and line
+ * endings. A buffer over the limits of the options is passed through
+ * unchanged. The work is shared by the calling thread and the tasks
+ * submitted to the executor, each of them formats all its buffers inside
+ * one reused arena. The results are in input order, a buffer which fails
+ * does not stop the others. The executor threads may call it as well.
+ */
+std::vector<ItemResult> formatBuffers(const std::vector<std::string_view> &inputs,
+                                      const formatter::FormatterOptions &options,
+                                      Executor &executor);
+
+/*
+ * Runs the batch on its own threads, zero means one per hardware thread.
+ */
+std::vector<ItemResult> formatBuffers(const std::vector<std::string_view> &inputs,
+                                      const formatter::FormatterOptions &options,
+                                      unsigned threads = 0);
+
+}
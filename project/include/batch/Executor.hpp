@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <functional>
+
+
+namespace batch
+{
+
+/*
+ * Runs tasks on threads owned by the caller of the batch API. Tasks do not
+ * throw and may run in any order.
+ */
+class Executor
+{
+public:
+    virtual ~Executor() = default;
+
+    /*
+     * The number of tasks worth submitting, usually the number of threads.
+     */
+    virtual unsigned concurrency() const noexcept = 0;
+
+    virtual void submit(std::function<void()> task) = 0;
+};
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "batch/Executor.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace batch
+{
+
+/*
+ * Executor running the tasks on a fixed set of threads. The destructor
+ * runs the tasks still queued before joining the threads.
+ */
+class ThreadPool : public Executor
+{
+public:
+    /*
+     * Zero threads means one per hardware thread.
+     */
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool& operator=(const ThreadPool &) = delete;
+
+    unsigned concurrency() const noexcept override;
+    void submit(std::function<void()> task) override;
+
+private:
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable has_tasks_;
+    std::deque<std::function<void()>> tasks_;
+    bool is_stopping_ {false};
+    std::vector<std::thread> threads_;
+};
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace cli
+{
+
+struct Arguments
+{
+    std::vector<std::string> files;
+    std::optional<std::string> git_base;
+    std::optional<std::string> trace_file;
+    std::vector<std::string> include_patterns;
+    std::vector<std::string> exclude_patterns;
+    unsigned jobs {0};
+    unsigned debounce_ms {50};
+    unsigned max_time_ms {0};
+    unsigned max_bytes {0};
+    unsigned max_lines {0};
+    unsigned max_depth {0};
+    bool in_place {false};
+    bool diff {false};
+    bool edits {false};
+    bool pipeline {false};
+    bool mapped_output {false};
+    bool watch {false};
+    bool lsp {false};
+    bool stats {false};
+};
+
+class InvalidArgumentError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+Arguments parseArguments(int argc, const char *const argv[]);
+
+std::string usage(const char *program_name);
+
+}
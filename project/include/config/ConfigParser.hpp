@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "formatter/FormatterOptions.hpp"
+
+#include <stdexcept>
+#include <string_view>
+
+
+namespace config
+{
+
+class ConfigError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct ParsedConfig
+{
+    bool is_root {false};
+};
+
+/*
+ * Applies "key = value" lines on top of the given options, so a config file
+ * overrides only the options it mentions. Lines starting with '#' are
+ * comments. Set values list their characters, white chars are skipped,
+ * e.g. "increase_indentation_chars = { (". Keyword values list words
+ * separated by white chars, e.g. "increase_indentation_keywords = begin do".
+ */
+ParsedConfig parseConfig(std::string_view content, formatter::FormatterOptions &options);
+
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "config/FileSystem.hpp"
+#include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/KeywordMatcher.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace config
+{
+
+constexpr const char *default_config_file_name = ".code-formatter";
+
+/*
+ * Resolves the options of a file from the config files found in its
+ * directory and all the parent directories; the nearest file wins and
+ * a file containing "root = true" stops the inheritance. Resolved options
+ * are cached per directory with the keyword automaton compiled from them,
+ * so each config file is read and compiled once, unless threads resolve
+ * its directory at the same time, and a cached directory does not look at
+ * its parents again. Safe to use from many threads.
+ */
+class ConfigResolver
+{
+public:
+    using OptionsPtr = std::shared_ptr<const formatter::FormatterOptions>;
+
+    /*
+     * The keyword matcher is null when the options have no keywords.
+     */
+    struct ResolvedOptions
+    {
+        OptionsPtr options;
+        formatter::detail::KeywordMatcherPtr keyword_matcher;
+    };
+
+    ConfigResolver(formatter::FormatterOptions default_options,
+                   FileSystem &file_system,
+                   std::string config_file_name = default_config_file_name);
+
+    ResolvedOptions resolveFile(const std::filesystem::path &file);
+
+    ResolvedOptions resolveDirectory(const std::filesystem::path &directory);
+
+    OptionsPtr optionsForFile(const std::filesystem::path &file);
+
+    OptionsPtr optionsForDirectory(const std::filesystem::path &directory);
+
+private:
+    std::optional<ResolvedOptions> findCached(const std::string &key);
+    ResolvedOptions resolve(const std::filesystem::path &directory);
+
+    const ResolvedOptions default_options_;
+    FileSystem &file_system_;
+    const std::string config_file_name_;
+
+    std::shared_mutex mutex_;
+    std::unordered_map<std::string, ResolvedOptions> cache_;
+};
+
+}
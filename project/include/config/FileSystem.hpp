@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+
+namespace config
+{
+
+class FileSystem
+{
+public:
+    virtual ~FileSystem() = default;
+
+    /*
+     * Returns the content of the file or nothing when it does not exist.
+     */
+    virtual std::optional<std::string> readFile(const std::filesystem::path &path) = 0;
+};
+
+class LocalFileSystem : public FileSystem
+{
+public:
+    std::optional<std::string> readFile(const std::filesystem::path &path) override;
+};
+
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+
+namespace diff
+{
+
+struct LineDiff
+{
+    std::vector<bool> removed;
+    std::vector<bool> added;
+};
+
+/*
+ * Computes a minimal line diff with the linear space variant of the Myers
+ * algorithm. Lines are compared by their hashes first. The common prefix
+ * and suffix are skipped before the search, so for documents with a few
+ * local changes, like formatting results, the cost is close to hashing
+ * the lines.
+ */
+LineDiff diffLines(const std::vector<std::string_view> &original,
+                   const std::vector<std::string_view> &modified);
+
+}
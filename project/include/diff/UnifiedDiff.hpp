@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <FileContent.hpp>
+#include "io/InputNormalizer.hpp"
+
+#include <cstddef>
+#include <string>
+
+
+namespace diff
+{
+
+constexpr std::size_t default_context_lines = 3;
+
+/*
+ * Returns a unified diff between both contents, or an empty string when
+ * they are equal. Lines are written with the line endings and the byte
+ * order mark described by the format, so the diff applies with patch to
+ * the original file.
+ */
+std::string unifiedDiff(const FileContent &original,
+                        const FileContent &formatted,
+                        const io::TextFormat &format,
+                        const std::string &original_label,
+                        const std::string &formatted_label,
+                        std::size_t context_lines = default_context_lines);
+
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "formatter/FormatterOptions.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+
+namespace formatter
+{
+
+class BudgetExceededError : public std::runtime_error
+{
+public:
+    enum class Limit
+    {
+        Time,
+        Bytes,
+        Lines,
+        IndentationDepth,
+    };
+
+    BudgetExceededError(Limit limit, std::size_t value);
+
+    Limit limit() const noexcept;
+
+private:
+    Limit limit_;
+};
+
+bool hasLimits(const FormatLimits &limits) noexcept;
+
+/*
+ * Tracks the work done on one file against its limits. The passes charge
+ * every line before formatting it and check the indentation depth after
+ * it, so an exceeded limit throws BudgetExceededError between lines and
+ * a single line is bounded by the bytes limit. The formatted content is
+ * left partially changed then, the callers keep the original one.
+ */
+class Budget
+{
+public:
+    explicit Budget(const FormatLimits &limits);
+
+    /*
+     * Lets the callers refuse an input before reading it.
+     */
+    void checkInputSize(std::size_t bytes) const;
+
+    void chargeLine(std::size_t bytes)
+    {
+        ++lines_;
+        bytes_ += bytes;
+        if (lines_ > lines_limit_ or bytes_ > bytes_limit_ or --lines_to_clock_check_ == 0 or bytes > clock_check_bytes) {
+            checkLimits();
+        }
+    }
+
+    void checkIndentationDepth(const std::size_t depth) const
+    {
+        if (depth > indentation_depth_limit_) {
+            throw BudgetExceededError(BudgetExceededError::Limit::IndentationDepth, indentation_depth_limit_);
+        }
+    }
+
+private:
+    static constexpr std::size_t clock_check_lines = 64;
+    static constexpr std::size_t clock_check_bytes = 64 * 1024;
+
+    void checkLimits();
+
+    std::size_t lines_limit_;
+    std::size_t bytes_limit_;
+    std::size_t indentation_depth_limit_;
+    std::chrono::milliseconds time_limit_;
+    std::chrono::steady_clock::time_point deadline_;
+
+    std::size_t lines_ {0};
+    std::size_t bytes_ {0};
+    std::size_t lines_to_clock_check_ {clock_check_lines};
+};
+
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+
+namespace formatter
+{
+
+/*
+ * Counts the input lines and their bytes, unchanged lines are the ones
+ * left untouched because they were already formatted.
+ */
+struct FormatStatistics
+{
+    std::size_t lines {0};
+    std::size_t bytes {0};
+    std::size_t unchanged_lines {0};
+    std::size_t unchanged_bytes {0};
+};
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "FileContent.hpp"
+#include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/SplitLine.hpp"
+#include "formatter/detail/UpdateIndentation.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+
+namespace formatter
+{
+
+/*
+ * Input range of the formatted lines of a normalized text, the same lines
+ * format() gives. Every input line is formatted only when the consumer
+ * advances past the lines produced before it, so the first line is ready
+ * at once and the remaining text is never analyzed when the consumer stops.
+ * The text and the options must outlive the range.
+ */
+class FormattedLines
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Line;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Line*;
+        using reference = const Line&;
+
+        Iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        Iterator& operator++();
+        void operator++(int);
+
+        bool operator==(const Iterator &other) const;
+        bool operator!=(const Iterator &other) const;
+
+    private:
+        friend class FormattedLines;
+
+        explicit Iterator(FormattedLines *lines);
+
+        bool isEnd() const;
+
+        FormattedLines *lines_ {nullptr};
+    };
+
+    FormattedLines(std::string_view normalized_text, const FormatterOptions &options);
+
+    FormattedLines(const FormattedLines &) = delete;
+    FormattedLines& operator=(const FormattedLines &) = delete;
+
+    /*
+     * The range is single pass, begin() continues from the current line.
+     */
+    Iterator begin();
+    Iterator end();
+
+private:
+    void fillPendingLines();
+    void next();
+
+    std::string_view remaining_text_;
+    detail::Splitter splitter_;
+    detail::Indenter indenter_;
+    FileContent pending_lines_;
+};
+
+}
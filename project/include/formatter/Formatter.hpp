@@ -9,13 +9,35 @@
 #pragma once
 
 #include "FileContent.hpp"
+#include "formatter/Budget.hpp"
+#include "formatter/FormatStatistics.hpp"
 #include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/KeywordMatcher.hpp"
+
+#include <vector>
 
 
 namespace formatter
 {
 
+/*
+ * When the limits of the options are exceeded, BudgetExceededError is
+ * thrown and the content is left partially formatted. The keyword
+ * automaton compiled once from the options may be shared by many calls,
+ * a null one is compiled by the call.
+ */
+FormatStatistics
+format(FileContent &content, const FormatterOptions &options,
+       detail::KeywordMatcherPtr keyword_matcher = nullptr);
+
+/*
+ * Formats only the lines from the given sorted ranges. The remaining lines
+ * are kept untouched, but they are still analyzed, so the formatted lines
+ * get the indentation resulting from the surrounding code.
+ */
 void
-format(FileContent &content, const FormatterOptions &options);
+format(FileContent &content, const FormatterOptions &options,
+       const std::vector<LineRange> &line_ranges,
+       detail::KeywordMatcherPtr keyword_matcher = nullptr);
 
 }
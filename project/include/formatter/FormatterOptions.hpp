@@ -8,12 +8,21 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <set>
+#include <string>
+#include <vector>
 
 
 namespace formatter
 {
 
+/*
+ * The keywords change the indentation like the chars, but a keyword
+ * starting or ending with a letter, a digit or '_' matches only as
+ * a whole word there, e.g. "end" does not match in "endif" or "legend".
+ */
 struct IndentationOptions
 {
     std::set<char> increase_indentation_chars;
@@ -21,11 +30,42 @@ struct IndentationOptions
     int num_of_spaces {0};
     bool reduce_indent_for_last_decrease_char {false};
     bool progressive_indent {false};
+    std::vector<std::string> increase_indentation_keywords;
+    std::vector<std::string> decrease_indentation_keywords;
+};
+
+/*
+ * The line is split after every split-after char and before every
+ * split-before char, as long as both parts contain a non-white text.
+ * A split-before char ending the line is moved to a new line only when
+ * the trailing delimiter is not kept. Consecutive delimiters of the same
+ * kind are split as one when the runs are kept.
+ */
+struct SplitOptions
+{
+    std::set<char> split_after_chars {';'};
+    std::set<char> split_before_chars;
+    bool keep_trailing_delimiter {true};
+    bool keep_delimiter_runs {false};
+};
+
+/*
+ * Work allowed for formatting one file, zero means no limit. The depth
+ * is the indentation level, counted in indentation steps.
+ */
+struct FormatLimits
+{
+    std::chrono::milliseconds time {0};
+    std::size_t bytes {0};
+    std::size_t lines {0};
+    std::size_t indentation_depth {0};
 };
 
 struct FormatterOptions
 {
     IndentationOptions indentation;
+    SplitOptions split;
+    FormatLimits limits;
 };
 
 }
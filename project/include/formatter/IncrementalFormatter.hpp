@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "FileContent.hpp"
+#include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/SplitLine.hpp"
+#include "formatter/detail/UpdateIndentation.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace formatter
+{
+
+/*
+ * Formats successive versions of the same document. The indentation state
+ * before every input line and the lines produced from it are kept between
+ * calls, so only the edited lines, and the following ones until the
+ * indentation state matches the previous version again, are formatted.
+ * The options must outlive the formatter. A null keyword automaton is
+ * compiled from them.
+ */
+class IncrementalFormatter
+{
+public:
+    explicit IncrementalFormatter(const FormatterOptions &options,
+                                  detail::KeywordMatcherPtr keyword_matcher = nullptr);
+
+    FileContent format(const FileContent &content);
+
+    /*
+     * Declares that the document now holds the last output, e.g. after it
+     * was written back, so the next version is compared with the output.
+     * Only the lines formatted by the last call are analyzed again.
+     */
+    void acceptOutput();
+
+    std::size_t lastFormattedLines() const noexcept;
+
+private:
+    struct LineState
+    {
+        Line input;
+        detail::Indenter indenter_before;
+        FileContent output;
+    };
+
+    const FormatterOptions &options_;
+    detail::Splitter splitter_;
+    std::vector<LineState> lines_;
+    detail::Indenter final_indenter_;
+    std::size_t last_formatted_begin_ {0};
+    std::size_t last_formatted_lines_ {0};
+};
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/KeywordMatcher.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace formatter
+{
+
+/*
+ * Replaces the length bytes at the offset of the original text.
+ */
+struct TextEdit
+{
+    std::size_t offset {0};
+    std::size_t length {0};
+    std::string replacement;
+};
+
+bool operator==(const TextEdit &lhs, const TextEdit &rhs);
+
+/*
+ * Returns the edits turning the raw input into the text format() and
+ * io::writeContent() give for it, ordered by offset and not overlapping.
+ * The edits are found while formatting, as the changed indentation and the
+ * line breaks inserted by the splits, so their number and size follow
+ * the changes instead of the input size. Line breaks other than the first
+ * one are replaced with it, as the writer does. Invalid input throws
+ * io::InvalidInputError, exceeded limits of the options throw
+ * BudgetExceededError. A null keyword automaton is compiled by the call.
+ */
+std::vector<TextEdit> formatEdits(std::string_view input, const FormatterOptions &options,
+                                  detail::KeywordMatcherPtr keyword_matcher = nullptr);
+
+/*
+ * Applies edits ordered by offset, e.g. the ones returned by formatEdits().
+ */
+std::string applyEdits(std::string_view text, const std::vector<TextEdit> &edits);
+
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <FileContent.hpp>
+#include "formatter/Budget.hpp"
+#include "formatter/FormatStatistics.hpp"
+#include "formatter/detail/SplitLine.hpp"
+#include "formatter/detail/UpdateIndentation.hpp"
+
+#include <string_view>
+
+
+namespace formatter::detail
+{
+
+/*
+ * Runs all the passes on a single input line and appends the resulting
+ * lines, allocated with the output's allocator, to the output. The indenter
+ * carries the state between lines. The budget, when given, is charged for
+ * the line.
+ */
+void formatLine(std::string_view input_line, const Splitter &splitter, Indenter &indenter, FileContent &output,
+                Budget *budget = nullptr);
+
+/*
+ * Formats the lines in place, continuing from the indenter state, so a
+ * document may be formatted in consecutive parts.
+ */
+FormatStatistics formatLines(FileContent &content, const Splitter &splitter, Indenter &indenter,
+                             Budget *budget = nullptr);
+
+}
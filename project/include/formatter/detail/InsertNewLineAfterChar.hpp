@@ -10,10 +10,19 @@
 
 #include <FileContent.hpp>
 
+#include <optional>
+
 
 namespace formatter::detail
 {
 
+/*
+ * Splits the line after the first occurrence of the character when it is
+ * followed by a non-white text. The line is truncated and the remaining part
+ * is returned, so it can be analyzed as the next line.
+ */
+std::optional<Line> splitLineAfterChar(Line &line, char character);
+
 void insertNewLineAfterChar(FileContent &content, char character);
 
 }
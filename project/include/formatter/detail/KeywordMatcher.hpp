@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "formatter/FormatterOptions.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+
+namespace formatter::detail
+{
+
+/*
+ * Finds the indentation triggers of a line in a single scan. The chars
+ * and keywords of the options are compiled into an Aho-Corasick automaton
+ * with a complete transition table, so every byte costs one lookup
+ * whatever the number of triggers. A keyword starting or ending with
+ * a word char matches only at a word boundary there, the trigger chars
+ * match anywhere. Matches do not overlap, the one ending first wins and
+ * of those ending together the longest one.
+ */
+class KeywordMatcher
+{
+public:
+    struct Match
+    {
+        std::size_t begin;
+        std::size_t end;
+        bool increases;
+        bool decreases;
+    };
+
+    explicit KeywordMatcher(const IndentationOptions &options);
+
+    static bool hasKeywords(const IndentationOptions &options) noexcept;
+
+    /*
+     * Returns null when the options have no keywords, the chars alone are
+     * looked up directly.
+     */
+    static std::shared_ptr<const KeywordMatcher> compile(const IndentationOptions &options);
+
+    /*
+     * Calls the callback with every match in the line starting at or
+     * after the given position, in order.
+     */
+    template <typename Callback>
+    void forEachMatch(std::string_view line, std::size_t from, Callback &&callback) const;
+
+private:
+    static constexpr std::int32_t no_state = -1;
+
+    struct State
+    {
+        std::int32_t output_link {no_state};
+        std::uint32_t length {0};
+        bool is_trigger {false};
+        bool increases {false};
+        bool decreases {false};
+        bool needs_boundary_before {false};
+        bool needs_boundary_after {false};
+    };
+
+    void addByteClasses(std::string_view trigger);
+    void addTrigger(std::string_view trigger, bool increases, bool is_keyword);
+    void compile();
+
+    bool isAtBoundaries(const State &state, std::string_view line, std::size_t begin, std::size_t end) const noexcept;
+
+    std::array<std::uint16_t, 256> byte_classes_ {};
+    std::size_t num_of_classes_ {1};
+    std::vector<State> states_;
+    std::vector<std::int32_t> transitions_;
+};
+
+using KeywordMatcherPtr = std::shared_ptr<const KeywordMatcher>;
+
+bool is_word_char(char c) noexcept;
+
+
+template <typename Callback>
+void
+KeywordMatcher::forEachMatch(const std::string_view line, const std::size_t from, Callback &&callback) const
+{
+    std::size_t state = 0;
+    std::size_t last_end = from;
+
+    for (std::size_t pos = from; pos < line.size(); ++pos) {
+        const auto byte_class = byte_classes_[static_cast<unsigned char>(line[pos])];
+        state = static_cast<std::size_t>(transitions_[state * num_of_classes_ + byte_class]);
+
+        auto output = states_[state].is_trigger ? static_cast<std::int32_t>(state) : states_[state].output_link;
+        for (; output != no_state; output = states_[output].output_link) {
+            const auto &trigger = states_[output];
+            const auto begin = pos + 1 - trigger.length;
+            if (begin >= last_end and isAtBoundaries(trigger, line, begin, pos + 1)) {
+                callback(Match {begin, pos + 1, trigger.increases, trigger.decreases});
+                last_end = pos + 1;
+                break;
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+
+namespace formatter::detail
+{
+
+/*
+ * Counts the elementary steps of the two formatting passes, the bytes
+ * scanned and copied by the line splitting and the bytes and indentation
+ * parts visited by the indentation, when built with
+ * FORMATTER_COUNT_OPERATIONS. Reading, normalizing and writing the files
+ * are not counted, the complexity tests check only their allocations.
+ * Other builds compile the counting to nothing. The counter is not thread
+ * safe, it is meant for single threaded tests only.
+ */
+#if defined(FORMATTER_COUNT_OPERATIONS)
+
+inline std::size_t counted_operations = 0;
+
+inline void
+countOperations(const std::size_t operations) noexcept
+{
+    counted_operations += operations;
+}
+
+#else
+
+inline void
+countOperations(std::size_t) noexcept
+{
+}
+
+#endif
+
+}
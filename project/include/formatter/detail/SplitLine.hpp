@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <FileContent.hpp>
+#include "formatter/FormatterOptions.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+
+namespace formatter::detail
+{
+
+/*
+ * Splits lines on all the configured delimiters in a single scan. The
+ * delimiters are looked up in a table, so the cost does not depend on
+ * their number.
+ */
+class Splitter
+{
+public:
+    explicit Splitter(const SplitOptions &options);
+
+    /*
+     * The line keeps the first part, the others are inserted after it.
+     * Returns the number of inserted lines.
+     */
+    std::size_t splitLine(FileContent &content, FileContent::iterator line_it) const;
+
+    /*
+     * Appends the positions where the parts after the first one begin.
+     */
+    void findCuts(std::string_view line, std::vector<std::size_t> &cuts) const;
+
+private:
+    enum DelimiterKind : std::uint8_t
+    {
+        split_after = 1,
+        split_before = 2,
+    };
+
+    template <typename Cut>
+    void forEachCut(std::string_view line, Cut cut) const;
+
+    std::uint8_t kindOf(char character) const noexcept;
+    bool isSplitAfter(std::string_view line, std::size_t pos, std::size_t text_end) const noexcept;
+    bool isSplitBefore(std::string_view line, std::size_t pos, std::size_t text_end) const noexcept;
+
+    std::array<std::uint8_t, 256> kinds_ {};
+    bool keep_trailing_delimiter_;
+    bool keep_delimiter_runs_;
+};
+
+void splitLines(FileContent &content, const SplitOptions &options);
+
+}
@@ -10,13 +10,65 @@
 
 #include <FileContent.hpp>
 #include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/KeywordMatcher.hpp"
 
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <set>
+#include <vector>
 
 
 namespace formatter::detail
 {
 
+/*
+ * Keeps the indentation state between lines, so the document can be
+ * indented line by line. The options must outlive the indenter. Copies
+ * are snapshots of the state, equal snapshots indent the following lines
+ * the same way. The keywords are matched by an automaton built once per
+ * indenter and shared by its copies, without keywords the chars are
+ * looked up directly. The indenters of many documents formatted with
+ * the same options may share one automaton too.
+ */
+class Indenter
+{
+public:
+    using NumberOfIndentationChars = long;
+    using IndentationParts = std::pmr::vector<NumberOfIndentationChars>;
+
+    explicit Indenter(const IndentationOptions &options,
+                      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /*
+     * Uses the given automaton, it must be compiled from the same options.
+     * A null one is compiled from them.
+     */
+    Indenter(const IndentationOptions &options,
+             KeywordMatcherPtr keyword_matcher,
+             std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+    /*
+     * Returns true when the line already had the computed indentation,
+     * such lines are left untouched.
+     */
+    bool updateLine(Line &line);
+
+    /*
+     * Number of indentation steps of the next line.
+     */
+    std::size_t indentationLevel() const;
+
+    bool operator==(const Indenter &other) const;
+    bool operator!=(const Indenter &other) const;
+
+private:
+    const IndentationOptions *options_;
+    KeywordMatcherPtr keyword_matcher_;
+    IndentationParts indentation_parts_;
+    NumberOfIndentationChars indentation_sum_ {0};
+};
+
 void updateIndentation(FileContent &content,
                        const IndentationOptions &options);
 
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <FileContent.hpp>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace git
+{
+
+/*
+ * Changed line ranges, in the new version of the file, keyed by the file
+ * path relative to the repository root.
+ */
+using ChangedLines = std::map<std::string, std::vector<LineRange>>;
+
+class GitError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+ChangedLines parseUnifiedDiff(std::string_view diff);
+
+std::string repositoryRoot(const std::string &directory);
+
+/*
+ * Asks the local repository which lines of the working tree differ from
+ * the base revision. Removed files and pure deletions are not reported.
+ */
+ChangedLines changedLines(const std::string &directory, const std::string &base_revision);
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <FileContent.hpp>
+#include "io/InputNormalizer.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+
+namespace io
+{
+
+std::pmr::string readRawFile(const char *name,
+                             std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+FileContent splitLines(std::string_view normalized_text,
+                       std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+/*
+ * Reads the file in blocks which end right after a line break, so every
+ * block can be normalized and split on its own. A block is extended past
+ * the requested size until a line break or the end of the file is found.
+ */
+class LineBlockReader
+{
+public:
+    explicit LineBlockReader(const char *name);
+    ~LineBlockReader();
+
+    LineBlockReader(const LineBlockReader &) = delete;
+    LineBlockReader& operator=(const LineBlockReader &) = delete;
+
+    /*
+     * Replaces the block with the next one and returns its offset in the
+     * file. The block is empty when the whole file was read.
+     */
+    std::size_t readBlock(std::pmr::string &block, std::size_t block_size);
+
+private:
+    void readSome(std::pmr::string &block, std::size_t size);
+
+    std::string name_;
+    int fd_;
+    std::string carry_;
+    std::size_t offset_ {0};
+    bool is_eof_ {false};
+};
+
+/*
+ * Reads, normalizes and splits the file. All the memory, including
+ * the temporary buffers, is allocated from the given resource.
+ */
+FileContent readFile(const char *name, TextFormat &format,
+                     std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+}
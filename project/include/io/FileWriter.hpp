@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <FileContent.hpp>
+#include "io/InputNormalizer.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+
+namespace io
+{
+
+constexpr std::string_view temporary_file_suffix = ".code-formatter.tmp";
+
+std::string_view lineEndingChars(LineEnding line_ending);
+
+void writeContent(std::ostream &output, const FileContent &content, const TextFormat &format);
+
+/*
+ * Appends the content to the string, reserving the needed space up front.
+ */
+void writeContent(std::string &output, const FileContent &content, const TextFormat &format);
+
+/*
+ * Writes the content next to the target file and renames it into place,
+ * so readers never observe a partially written file.
+ */
+void writeFile(const std::string &name, const FileContent &content, const TextFormat &format);
+
+void writeFile(const std::string &name, std::string_view data);
+
+/*
+ * Streams the content produced by the callback into the file. When the
+ * callback throws, the file is left untouched.
+ */
+void writeFile(const std::string &name, const std::function<void(std::ostream &)> &write);
+
+struct MappedWriteOptions
+{
+    unsigned threads {0};
+    std::size_t min_bytes_per_thread {4 * 1024 * 1024};
+};
+
+/*
+ * Like writeFile, but the output offsets of all the lines are computed
+ * first, the temporary file is sized once and mapped into memory, and
+ * the lines are copied into it by several threads writing disjoint
+ * ranges. Meant for very large files.
+ */
+void writeFileMapped(const std::string &name, const FileContent &content, const TextFormat &format,
+                     const MappedWriteOptions &options = MappedWriteOptions{});
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+
+namespace io
+{
+
+enum class LineEnding
+{
+    LF,
+    CRLF,
+    CR,
+};
+
+struct TextFormat
+{
+    LineEnding line_ending {LineEnding::LF};
+    bool has_bom {false};
+    bool ends_with_newline {true};
+};
+
+struct NormalizedInput
+{
+    std::pmr::string text;
+    TextFormat format;
+};
+
+class InvalidInputError : public std::runtime_error
+{
+public:
+    explicit InvalidInputError(std::size_t offset);
+
+    std::size_t offset() const noexcept;
+
+private:
+    std::size_t offset_;
+};
+
+/*
+ * Validates UTF-8, strips the BOM and converts CRLF/CR line endings to LF.
+ * The line ending of the first line break is recorded in the returned format,
+ * so the writer is able to restore it. On invalid input InvalidInputError is
+ * thrown with the offset of the first byte of the offending sequence.
+ */
+NormalizedInput normalizeInput(std::string_view data,
+                               std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+/*
+ * Normalizes a part of the input which starts at the given offset, after
+ * a line break. The BOM is not recognized there and error offsets are
+ * reported relative to the whole input.
+ */
+NormalizedInput normalizeInputBlock(std::string_view data, std::size_t offset,
+                                    std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+
+namespace json
+{
+
+class Value;
+
+using Array = std::vector<Value>;
+
+/*
+ * Members keep their order; objects are small, so they are looked up
+ * linearly.
+ */
+using Object = std::vector<std::pair<std::string, Value>>;
+
+class Value
+{
+public:
+    Value() = default;
+    Value(std::nullptr_t);
+    Value(bool value);
+    Value(int value);
+    Value(std::int64_t value);
+    Value(std::size_t value);
+    Value(double value);
+    Value(const char *value);
+    Value(std::string value);
+    Value(Array value);
+    Value(Object value);
+
+    bool isNull() const noexcept;
+    bool isBool() const noexcept;
+    bool isNumber() const noexcept;
+    bool isString() const noexcept;
+    bool isArray() const noexcept;
+    bool isObject() const noexcept;
+
+    /*
+     * The accessors throw TypeError when the value has another type.
+     */
+    bool asBool() const;
+    double asNumber() const;
+    std::int64_t asInteger() const;
+    const std::string& asString() const;
+    const Array& asArray() const;
+    const Object& asObject() const;
+
+    /*
+     * Returns the member or nullptr when the value is not an object or
+     * does not have it.
+     */
+    const Value* find(std::string_view key) const;
+
+    /*
+     * Returns the member or a null value.
+     */
+    const Value& operator[](std::string_view key) const;
+
+    bool operator==(const Value &other) const;
+    bool operator!=(const Value &other) const;
+
+private:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value_;
+};
+
+class ParseError : public std::runtime_error
+{
+public:
+    ParseError(std::size_t offset, const std::string &message);
+
+    std::size_t offset() const noexcept;
+
+private:
+    std::size_t offset_;
+};
+
+class TypeError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/*
+ * Parses a complete JSON text. Nesting is limited, so a hostile input
+ * can not exhaust the stack.
+ */
+Value parse(std::string_view text);
+
+/*
+ * Writes the value in the compact form; integral numbers are written
+ * without a fraction.
+ */
+void write(std::ostream &output, const Value &value);
+
+std::string toString(const Value &value);
+
+/*
+ * Writes the text as a quoted JSON string. The text is expected to be
+ * UTF-8, only the quote, the backslash and the control chars are escaped.
+ */
+void writeString(std::ostream &output, std::string_view text);
+
+}
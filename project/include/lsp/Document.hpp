@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace lsp
+{
+
+/*
+ * Unit of the character offsets in positions, negotiated with the client.
+ */
+enum class PositionEncoding
+{
+    Utf16,
+    Utf8,
+};
+
+struct Position
+{
+    std::size_t line {0};
+    std::size_t character {0};
+};
+
+bool operator==(const Position &lhs, const Position &rhs);
+
+/*
+ * Text of an open document, kept as the client sent it. Lines end with
+ * LF, CRLF or CR. The line index mapping positions to offsets is built
+ * on first use after a change.
+ */
+class Document
+{
+public:
+    Document(std::string text, std::int64_t version, PositionEncoding encoding);
+
+    const std::string& text() const noexcept;
+
+    std::int64_t version() const noexcept;
+
+    /*
+     * Positions past the end of a line or of the document are clamped
+     * to it, as the protocol asks for.
+     */
+    std::size_t offsetAt(const Position &position) const;
+
+    Position positionAt(std::size_t offset) const;
+
+    std::size_t lineCount() const;
+
+    /*
+     * Replaces the text between the positions; the whole text is replaced
+     * by setText().
+     */
+    void replace(const Position &begin, const Position &end, std::string_view text);
+
+    void setText(std::string text);
+
+    void setVersion(std::int64_t version) noexcept;
+
+private:
+    const std::vector<std::size_t>& lineStarts() const;
+
+    std::size_t lineEnd(std::size_t line) const;
+
+    std::string text_;
+    std::int64_t version_;
+    PositionEncoding encoding_;
+
+    mutable std::vector<std::size_t> line_starts_;
+    mutable bool is_indexed_ {false};
+};
+
+}
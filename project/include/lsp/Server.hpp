@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "config/ConfigResolver.hpp"
+#include "config/FileSystem.hpp"
+#include "formatter/FormatterOptions.hpp"
+#include "formatter/TextEdits.hpp"
+#include "json/Json.hpp"
+#include "lsp/Document.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace lsp
+{
+
+/*
+ * Language server formatting the documents open in the client. The texts
+ * are kept in memory and updated by the incremental changes, the options
+ * of a document are resolved from the config files next to it when it is
+ * opened. The edits of a document are computed once per version and
+ * shared by all the formatting requests.
+ */
+class Server
+{
+public:
+    Server(formatter::FormatterOptions default_options, config::FileSystem &file_system);
+
+    /*
+     * Serves the messages until the exit notification or the end of
+     * the input. Returns the exit code, which is zero only when the client
+     * asked for the shutdown first.
+     */
+    int run(std::istream &input, std::ostream &output);
+
+    /*
+     * Handles one message and returns the response, notifications do not
+     * get one.
+     */
+    std::optional<json::Value> handle(const json::Value &message);
+
+    bool isExitRequested() const noexcept;
+
+private:
+    struct OpenDocument
+    {
+        Document document;
+        std::optional<std::filesystem::path> path;
+        std::optional<config::ConfigResolver::ResolvedOptions> options;
+        std::optional<std::vector<formatter::TextEdit>> edits;
+    };
+
+    json::Value call(const std::string &method, const json::Value &params);
+    void notify(const std::string &method, const json::Value &params);
+
+    json::Value initialize(const json::Value &params);
+    void didOpen(const json::Value &params);
+    void didChange(const json::Value &params);
+    void didClose(const json::Value &params);
+    json::Value formatting(const json::Value &params);
+    json::Value rangeFormatting(const json::Value &params);
+    json::Value onTypeFormatting(const json::Value &params);
+
+    OpenDocument& openDocument(const json::Value &params);
+    const std::vector<formatter::TextEdit>& edits(OpenDocument &open_document);
+    json::Value editsOnLines(OpenDocument &open_document, std::size_t first_line, std::size_t last_line);
+
+    const config::ConfigResolver::ResolvedOptions default_options_;
+    config::ConfigResolver config_resolver_;
+    PositionEncoding encoding_ {PositionEncoding::Utf16};
+
+    std::unordered_map<std::string, OpenDocument> documents_;
+
+    bool is_initialized_ {false};
+    bool is_shutdown_requested_ {false};
+    bool is_exit_requested_ {false};
+};
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+
+namespace lsp
+{
+
+class ProtocolError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/*
+ * Reads the content of one message framed with the Content-Length header.
+ * Returns nothing at the end of the input before a message begins, a broken
+ * or truncated message throws ProtocolError.
+ */
+std::optional<std::string> readMessage(std::istream &input);
+
+/*
+ * Writes the content framed with the Content-Length header and flushes
+ * the output, so the client gets the message at once.
+ */
+void writeMessage(std::ostream &output, std::string_view content);
+
+}
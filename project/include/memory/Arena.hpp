@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "memory/CountingResource.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+
+namespace memory
+{
+
+struct ArenaStatistics
+{
+    std::size_t capacity {0};
+    std::size_t resets {0};
+    std::size_t upstream_allocations {0};
+    std::size_t upstream_bytes {0};
+    std::size_t cycle_allocations {0};
+    std::size_t cycle_bytes {0};
+    std::size_t cycle_upstream_allocations {0};
+};
+
+/*
+ * Monotonic arena for the documents of a single file. Everything allocated
+ * from it is released at once by reset(), which makes it ready for the next
+ * file. When a file did not fit into the initial buffer, the buffer is grown
+ * on reset, so in the steady state files are formatted without touching the
+ * upstream resource at all. Not thread safe, meant to be owned by a worker.
+ */
+class Arena : public std::pmr::memory_resource
+{
+public:
+    explicit Arena(std::size_t initial_capacity = 64 * 1024,
+                   std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+    ~Arena() override;
+
+    Arena(const Arena &) = delete;
+    Arena& operator=(const Arena &) = delete;
+
+    /*
+     * Releases all the memory allocated since the last reset. No object
+     * allocated from the arena may be used afterwards.
+     */
+    void reset();
+
+    ArenaStatistics statistics() const noexcept;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    void allocateBuffer(std::size_t capacity);
+
+    CountingResource upstream_;
+    void *buffer_ {nullptr};
+    std::size_t capacity_ {0};
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic_;
+
+    std::size_t resets_ {0};
+    std::size_t cycle_allocations_ {0};
+    std::size_t cycle_bytes_ {0};
+    std::size_t cycle_upstream_start_ {0};
+};
+
+}
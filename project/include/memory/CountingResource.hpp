@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+
+namespace memory
+{
+
+struct AllocationStatistics
+{
+    std::size_t allocations {0};
+    std::size_t deallocations {0};
+    std::size_t allocated_bytes {0};
+};
+
+/*
+ * Forwards to the upstream resource and counts the requests. Not thread
+ * safe, every thread should use its own instance.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    explicit CountingResource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+    const AllocationStatistics& statistics() const noexcept;
+
+    void resetStatistics() noexcept;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    std::pmr::memory_resource *upstream_;
+    AllocationStatistics statistics_;
+};
+
+}
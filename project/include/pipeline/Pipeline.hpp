@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "formatter/FormatStatistics.hpp"
+#include "formatter/FormatterOptions.hpp"
+#include "formatter/detail/KeywordMatcher.hpp"
+#include "trace/Tracer.hpp"
+
+#include <cstddef>
+#include <ostream>
+
+
+namespace pipeline
+{
+
+struct PipelineOptions
+{
+    std::size_t block_size {1024 * 1024};
+    std::size_t blocks {8};
+    trace::Tracer *tracer {nullptr};
+
+    /*
+     * Compiled from the formatter options when null.
+     */
+    formatter::detail::KeywordMatcherPtr keyword_matcher;
+};
+
+/*
+ * Formats a single file with reading, formatting and writing running at
+ * the same time on separate threads. The stages pass blocks of lines
+ * through lock-free queues and the written blocks are recycled, so the
+ * memory use is bounded by the number of blocks. When an exception is
+ * thrown, part of the output may already be written.
+ */
+formatter::FormatStatistics formatFile(const char *name,
+                                       const formatter::FormatterOptions &options,
+                                       std::ostream &output,
+                                       const PipelineOptions &pipeline_options = PipelineOptions{});
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace pipeline
+{
+
+/*
+ * Bounded lock-free ring buffer for exactly one producer thread and one
+ * consumer thread. The capacity is rounded up to a power of two.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(const std::size_t capacity)
+        : slots_(roundUpToPowerOfTwo(capacity)),
+          mask_(slots_.size() - 1)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue& operator=(const SpscQueue &) = delete;
+
+    std::size_t capacity() const noexcept
+    {
+        return slots_.size();
+    }
+
+    /*
+     * Returns false when the queue is full, the value is not moved then.
+     */
+    bool tryPush(T &value)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == slots_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == slots_.size()) {
+                return false;
+            }
+        }
+
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &value)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static std::size_t roundUpToPowerOfTwo(const std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value) {
+            result *= 2;
+        }
+
+        return result;
+    }
+
+    static constexpr std::size_t cache_line_size = 64;
+
+    std::vector<T> slots_;
+    const std::size_t mask_;
+
+    alignas(cache_line_size) std::atomic<std::size_t> head_ {0};
+    std::size_t cached_tail_ {0};
+
+    alignas(cache_line_size) std::atomic<std::size_t> tail_ {0};
+    std::size_t cached_head_ {0};
+};
+
+}
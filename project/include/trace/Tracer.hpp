@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+
+namespace trace
+{
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * Collects timed spans from many threads. Every thread appends to its own
+ * buffer without locking, the buffers are only linked together when a
+ * thread records its first span. The trace may be written once the traced
+ * threads are done.
+ */
+class Tracer
+{
+public:
+    Tracer();
+    ~Tracer();
+
+    Tracer(const Tracer &) = delete;
+    Tracer& operator=(const Tracer &) = delete;
+
+    /*
+     * Makes the file the subject of the following spans recorded by the
+     * calling thread. Returns the previous subject, to be restored later.
+     */
+    const std::string* enterFile(std::string_view name);
+    void leaveFile(const std::string *previous_file) noexcept;
+
+    void record(const char *name, Clock::time_point begin, Clock::time_point end);
+
+    /*
+     * Writes the spans in the Chrome trace event format, which can be
+     * loaded in Perfetto or chrome://tracing.
+     */
+    void write(std::ostream &output) const;
+
+private:
+    struct ThreadBuffer;
+
+    ThreadBuffer& threadBuffer();
+
+    const std::uint64_t id_;
+    const Clock::time_point start_;
+    std::atomic<ThreadBuffer*> buffers_ {nullptr};
+    std::atomic<std::uint32_t> threads_ {0};
+};
+
+/*
+ * Records the time between construction and destruction. Spans with
+ * a file make it the subject of the spans nested in them. Without a tracer
+ * nothing is recorded.
+ */
+class Span
+{
+public:
+    Span(Tracer *tracer, const char *name) noexcept;
+    Span(Tracer *tracer, const char *name, std::string_view file);
+    ~Span();
+
+    Span(const Span &) = delete;
+    Span& operator=(const Span &) = delete;
+
+private:
+    Tracer *tracer_;
+    const char *name_;
+    bool is_file_span_ {false};
+    const std::string *previous_file_ {nullptr};
+    Clock::time_point begin_;
+};
+
+}
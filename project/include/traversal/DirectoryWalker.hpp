@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "traversal/GlobPattern.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+
+namespace traversal
+{
+
+using FileCallback = std::function<void(const std::filesystem::path &)>;
+using ErrorCallback = std::function<void(const std::filesystem::path &, const std::error_code &)>;
+
+struct WalkerOptions
+{
+    std::vector<std::string> include_patterns;
+    std::vector<std::string> exclude_patterns;
+    std::vector<std::string> ignore_file_names {".gitignore", ".code-formatter-ignore"};
+    unsigned threads {0};
+    ErrorCallback on_error;
+};
+
+/*
+ * Walks the directories with a pool of threads. The files found in
+ * a directory are queued in small batches and passed to the callback by
+ * any thread of the pool, so the callback must be thread safe. The queue
+ * keeps the directories waiting for a scan and the files of the scanned
+ * ones. Patterns containing '/' are matched against the path relative
+ * to the walked root, the others against the file name. Files given
+ * directly are always passed to the callback, from the same threads.
+ * Symbolic links found in the directories are skipped, so a file is not
+ * replaced when its link is written in place.
+ */
+class DirectoryWalker
+{
+public:
+    explicit DirectoryWalker(WalkerOptions options);
+
+    void walk(const std::vector<std::filesystem::path> &paths, const FileCallback &on_file) const;
+
+private:
+    WalkerOptions options_;
+    std::vector<GlobPattern> include_patterns_;
+    std::vector<GlobPattern> exclude_patterns_;
+};
+
+}
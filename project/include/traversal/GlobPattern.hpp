@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+
+namespace traversal
+{
+
+/*
+ * Glob pattern matched against '/' separated paths. Supports '*' and '?'
+ * (not matching '/'), '**' (matching any number of directories), character
+ * classes and backslash escapes.
+ */
+class GlobPattern
+{
+public:
+    explicit GlobPattern(std::string_view pattern);
+
+    bool matches(std::string_view path) const;
+
+    const std::string& pattern() const noexcept;
+
+private:
+    enum class Kind
+    {
+        Literal,
+        Suffix,
+        General,
+    };
+
+    std::string pattern_;
+    std::string literal_;
+    Kind kind_;
+};
+
+}
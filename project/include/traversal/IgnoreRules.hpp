@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "traversal/GlobPattern.hpp"
+
+#include <string_view>
+#include <vector>
+
+
+namespace traversal
+{
+
+/*
+ * Rules from a single ignore file, using the .gitignore syntax: comments,
+ * '!' negation, trailing '/' for directories and patterns containing '/'
+ * anchored to the directory of the ignore file.
+ */
+class IgnoreRules
+{
+public:
+    enum class Match
+    {
+        None,
+        Ignored,
+        Included,
+    };
+
+    static IgnoreRules parse(std::string_view content);
+
+    void addRule(std::string_view rule);
+
+    /*
+     * The path is relative to the directory containing the ignore file.
+     * The last matching rule decides.
+     */
+    Match match(std::string_view relative_path, bool is_directory) const;
+
+    bool empty() const noexcept;
+
+private:
+    struct Rule
+    {
+        GlobPattern pattern;
+        bool negated;
+        bool directory_only;
+        bool anchored;
+    };
+
+    std::vector<Rule> rules_;
+};
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "config/ConfigResolver.hpp"
+#include "formatter/IncrementalFormatter.hpp"
+#include "watch/Watcher.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+
+
+namespace watch
+{
+
+struct EventReport
+{
+    enum class Result
+    {
+        Formatted,
+        AlreadyFormatted,
+        OwnWrite,
+    };
+
+    Result result {Result::Formatted};
+    std::size_t formatted_lines {0};
+    std::size_t total_lines {0};
+    std::chrono::microseconds format_time {0};
+    std::chrono::microseconds latency {0};
+};
+
+/*
+ * Reformats changed files in place, keeping the formatting state of every
+ * seen file between events. Events caused by the session's own writes are
+ * recognized by the content hash of the written data and skipped.
+ */
+class WatchSession
+{
+public:
+    explicit WatchSession(config::ConfigResolver &config_resolver);
+
+    EventReport handle(const ChangeEvent &event);
+
+private:
+    struct FileState
+    {
+        config::ConfigResolver::OptionsPtr options;
+        std::unique_ptr<formatter::IncrementalFormatter> formatter;
+        std::size_t written_hash {0};
+        bool has_written {false};
+    };
+
+    config::ConfigResolver &config_resolver_;
+    std::map<std::filesystem::path, FileState> files_;
+};
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+
+namespace watch
+{
+
+struct ChangeEvent
+{
+    std::filesystem::path path;
+    std::chrono::steady_clock::time_point received;
+};
+
+/*
+ * Reports files written or moved into the watched paths, using inotify.
+ * Directories are watched recursively, including the ones created later.
+ * Single files are watched through their parent directory, so editors
+ * replacing the file with a rename are noticed too.
+ */
+class Watcher
+{
+public:
+    Watcher();
+    ~Watcher();
+
+    Watcher(const Watcher &) = delete;
+    Watcher& operator=(const Watcher &) = delete;
+
+    void addPath(const std::filesystem::path &path);
+
+    /*
+     * Waits up to the timeout for the first event, then collects the
+     * following ones until there is a quiet period of the debounce length.
+     * Every changed file is reported once, with the time of its first
+     * event. Returns an empty list on timeout.
+     */
+    std::vector<ChangeEvent> waitForChanges(std::chrono::milliseconds debounce,
+                                            std::chrono::milliseconds timeout);
+
+private:
+    void addDirectory(const std::filesystem::path &directory, bool recursive);
+    bool readEvents(std::map<std::filesystem::path, std::chrono::steady_clock::time_point> &changes);
+
+    struct WatchedDirectory
+    {
+        std::filesystem::path path;
+        bool recursive;
+        std::set<std::string> file_names;
+    };
+
+    int inotify_fd_;
+    std::map<int, WatchedDirectory> directories_;
+};
+
+}
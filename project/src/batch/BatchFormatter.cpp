@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <batch/BatchFormatter.hpp>
+#include <batch/ThreadPool.hpp>
+
+#include <FileContent.hpp>
+#include <formatter/Budget.hpp>
+#include <formatter/detail/FormatLine.hpp>
+#include <formatter/detail/SplitLine.hpp>
+#include <formatter/detail/UpdateIndentation.hpp>
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+#include <io/InputNormalizer.hpp>
+#include <memory/Arena.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+
+namespace batch
+{
+
+namespace
+{
+
+/*
+ * Shared by the tasks of one batch. A task started after all the items were
+ * taken finds nothing to do, so it only touches the state it co-owns and
+ * may outlive the call. The splitter and the keyword automaton are built
+ * once for all the items.
+ */
+struct BatchState
+{
+    BatchState(const std::vector<std::string_view> &inputs, const formatter::FormatterOptions &options)
+        : inputs(inputs),
+          options(options),
+          splitter(options.split),
+          keyword_matcher(formatter::detail::KeywordMatcher::compile(options.indentation)),
+          items(inputs.size()),
+          results(inputs.size())
+    {
+    }
+
+    const std::vector<std::string_view> &inputs;
+    const formatter::FormatterOptions &options;
+    const formatter::detail::Splitter splitter;
+    const formatter::detail::KeywordMatcherPtr keyword_matcher;
+    const std::size_t items;
+    std::vector<ItemResult> results;
+
+    std::atomic<std::size_t> next_item {0};
+    std::mutex mutex;
+    std::condition_variable all_done;
+    std::size_t done_items {0};
+};
+
+
+ItemResult
+formatItem(const std::string_view input, const BatchState &state, memory::Arena &arena)
+{
+    ItemResult result;
+
+    try {
+        const auto normalized = io::normalizeInput(input, &arena);
+        auto content = io::splitLines(normalized.text, &arena);
+
+        std::optional<formatter::Budget> budget;
+        if (formatter::hasLimits(state.options.limits)) {
+            budget.emplace(state.options.limits);
+            budget->checkInputSize(input.size());
+        }
+
+        formatter::detail::Indenter indenter(state.options.indentation, state.keyword_matcher, &arena);
+        result.statistics = formatter::detail::formatLines(content, state.splitter, indenter,
+                                                           budget ? &*budget : nullptr);
+
+        io::writeContent(result.output, content, normalized.format);
+        result.status = ItemResult::Status::Formatted;
+    }
+    catch (const formatter::BudgetExceededError &e) {
+        result.status = ItemResult::Status::BudgetExceeded;
+        result.output.assign(input);
+        result.error = e.what();
+    }
+    catch (const io::InvalidInputError &e) {
+        result.status = ItemResult::Status::InvalidInput;
+        result.error = e.what();
+    }
+    catch (const std::exception &e) {
+        result.status = ItemResult::Status::Failed;
+        result.output.clear();
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+
+void
+formatItems(BatchState &state)
+{
+    auto item = state.next_item++;
+    if (item >= state.items) {
+        return;
+    }
+
+    memory::Arena arena;
+    std::size_t done_items = 0;
+
+    for (; item < state.items; item = state.next_item++) {
+        state.results[item] = formatItem(state.inputs[item], state, arena);
+        arena.reset();
+        ++done_items;
+    }
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.done_items += done_items;
+    if (state.done_items == state.items) {
+        state.all_done.notify_all();
+    }
+}
+
+
+/*
+ * The calling thread takes part, so the batch completes even when the
+ * executor threads are busy or submitting fails.
+ */
+std::vector<ItemResult>
+runBatch(const std::vector<std::string_view> &inputs,
+         const formatter::FormatterOptions &options,
+         Executor *executor)
+{
+    auto state = std::make_shared<BatchState>(inputs, options);
+
+    if (executor and inputs.size() > 1) {
+        const auto tasks = std::min<std::size_t>(executor->concurrency(), inputs.size() - 1);
+        try {
+            for (std::size_t i = 0; i < tasks; ++i) {
+                executor->submit([state] { formatItems(*state); });
+            }
+        }
+        catch (const std::exception &) {
+        }
+    }
+
+    formatItems(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->all_done.wait(lock, [&state] { return state->done_items == state->items; });
+    return std::move(state->results);
+}
+
+}
+
+
+std::vector<ItemResult>
+formatBuffers(const std::vector<std::string_view> &inputs,
+              const formatter::FormatterOptions &options,
+              Executor &executor)
+{
+    return runBatch(inputs, options, &executor);
+}
+
+
+std::vector<ItemResult>
+formatBuffers(const std::vector<std::string_view> &inputs,
+              const formatter::FormatterOptions &options,
+              unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, inputs.size()));
+
+    if (threads <= 1) {
+        return runBatch(inputs, options, nullptr);
+    }
+
+    ThreadPool thread_pool(threads - 1);
+    return runBatch(inputs, options, &thread_pool);
+}
+
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <cli/Arguments.hpp>
+
+#include <string_view>
+
+
+namespace cli
+{
+
+namespace
+{
+
+/*
+ * Returns the value of "--name=value" or "--name value" options and moves
+ * the index past the consumed arguments. Short options take an attached
+ * value as well, e.g. "-j4".
+ */
+std::optional<std::string>
+optionValue(const std::string_view name, int &index, const int argc, const char *const argv[])
+{
+    const std::string_view argument = argv[index];
+    if (argument.substr(0, name.size()) != name) {
+        return std::nullopt;
+    }
+
+    const auto rest = argument.substr(name.size());
+    if (rest.empty()) {
+        if (index + 1 >= argc) {
+            throw InvalidArgumentError("missing value for " + std::string(name));
+        }
+        ++index;
+        return std::string(argv[index]);
+    }
+    if (rest.front() == '=') {
+        return std::string(rest.substr(1));
+    }
+    if (name.size() == 2) {
+        return std::string(rest);
+    }
+
+    return std::nullopt;
+}
+
+
+unsigned
+parseUnsigned(const std::string &value, const std::string_view name)
+{
+    try {
+        std::size_t parsed_chars = 0;
+        const auto number = std::stoul(value, &parsed_chars);
+        if (parsed_chars == value.size()) {
+            return static_cast<unsigned>(number);
+        }
+    }
+    catch (const std::logic_error &) {
+    }
+
+    throw InvalidArgumentError("invalid value for " + std::string(name) + ": " + value);
+}
+
+}
+
+
+Arguments
+parseArguments(const int argc, const char *const argv[])
+{
+    Arguments arguments;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument = argv[i];
+
+        if (argument == "-i" or argument == "--in-place") {
+            arguments.in_place = true;
+        }
+        else if (argument == "--diff") {
+            arguments.diff = true;
+        }
+        else if (argument == "--edits") {
+            arguments.edits = true;
+        }
+        else if (argument == "--mapped-output") {
+            arguments.mapped_output = true;
+        }
+        else if (argument == "--pipeline") {
+            arguments.pipeline = true;
+        }
+        else if (argument == "--watch") {
+            arguments.watch = true;
+        }
+        else if (argument == "--lsp") {
+            arguments.lsp = true;
+        }
+        else if (argument == "--stats") {
+            arguments.stats = true;
+        }
+        else if (auto value = optionValue("--debounce", i, argc, argv)) {
+            arguments.debounce_ms = parseUnsigned(*value, "--debounce");
+        }
+        else if (auto value = optionValue("--max-time", i, argc, argv)) {
+            arguments.max_time_ms = parseUnsigned(*value, "--max-time");
+        }
+        else if (auto value = optionValue("--max-bytes", i, argc, argv)) {
+            arguments.max_bytes = parseUnsigned(*value, "--max-bytes");
+        }
+        else if (auto value = optionValue("--max-lines", i, argc, argv)) {
+            arguments.max_lines = parseUnsigned(*value, "--max-lines");
+        }
+        else if (auto value = optionValue("--max-depth", i, argc, argv)) {
+            arguments.max_depth = parseUnsigned(*value, "--max-depth");
+        }
+        else if (auto value = optionValue("--git-base", i, argc, argv)) {
+            arguments.git_base = std::move(value);
+        }
+        else if (auto value = optionValue("--trace", i, argc, argv)) {
+            arguments.trace_file = std::move(value);
+        }
+        else if (auto value = optionValue("--include", i, argc, argv)) {
+            arguments.include_patterns.push_back(std::move(*value));
+        }
+        else if (auto value = optionValue("--exclude", i, argc, argv)) {
+            arguments.exclude_patterns.push_back(std::move(*value));
+        }
+        else if (auto value = optionValue("--jobs", i, argc, argv)) {
+            arguments.jobs = parseUnsigned(*value, "--jobs");
+        }
+        else if (auto value = optionValue("-j", i, argc, argv)) {
+            arguments.jobs = parseUnsigned(*value, "-j");
+        }
+        else if (argument.size() > 1 and argument.front() == '-') {
+            throw InvalidArgumentError("unknown option: " + std::string(argument));
+        }
+        else {
+            arguments.files.emplace_back(argument);
+        }
+    }
+
+    if (arguments.files.empty() and not arguments.git_base and not arguments.lsp) {
+        throw InvalidArgumentError("no input files");
+    }
+    if (arguments.lsp and (not arguments.files.empty() or arguments.git_base or arguments.trace_file
+                           or arguments.in_place or arguments.diff or arguments.edits
+                           or arguments.pipeline or arguments.watch)) {
+        throw InvalidArgumentError("--lsp can not be used with input files or other modes");
+    }
+    if (arguments.watch and arguments.git_base) {
+        throw InvalidArgumentError("--watch can not be used with --git-base");
+    }
+    if (arguments.trace_file and arguments.watch) {
+        throw InvalidArgumentError("--trace can not be used with --watch");
+    }
+    if (arguments.diff and (arguments.in_place or arguments.watch)) {
+        throw InvalidArgumentError("--diff can not be used with --in-place or --watch");
+    }
+    if (arguments.edits and (arguments.in_place or arguments.diff or arguments.pipeline
+                             or arguments.watch or arguments.git_base)) {
+        throw InvalidArgumentError("--edits can not be used with --in-place, --diff, --pipeline, --watch or --git-base");
+    }
+    if (arguments.pipeline and (arguments.diff or arguments.watch or arguments.git_base)) {
+        throw InvalidArgumentError("--pipeline can not be used with --diff, --watch or --git-base");
+    }
+    if (arguments.mapped_output and (arguments.pipeline or not (arguments.in_place or arguments.git_base))) {
+        throw InvalidArgumentError("--mapped-output requires --in-place or --git-base and can not be used with --pipeline");
+    }
+
+    return arguments;
+}
+
+
+std::string
+usage(const char *program_name)
+{
+    return std::string("usage: ") + program_name + " [options] [FILE|DIRECTORY...]\n"
+        "\n"
+        "options:\n"
+        "  -i, --in-place        write the formatted content back to the files\n"
+        "  --diff                print a unified diff of the changes instead of\n"
+        "                        the formatted content\n"
+        "  --edits               print the text edits formatting each file, one\n"
+        "                        JSON object per changed file\n"
+        "  --git-base=REVISION   format only the lines changed since REVISION,\n"
+        "                        the changed files are rewritten in place\n"
+        "  --include=GLOB        format only matching files found in directories\n"
+        "  --exclude=GLOB        skip matching files and directories\n"
+        "  -j, --jobs=N          number of threads used to walk and format\n"
+        "  --mapped-output       write the files in place through a memory mapping,\n"
+        "                        the files changed since --git-base are copied\n"
+        "                        with several threads\n"
+        "  --pipeline            read, format and write each file at the same\n"
+        "                        time on separate threads, for large files\n"
+        "  --watch               reformat the files in place whenever they change\n"
+        "  --debounce=MS         quiet period collecting a burst of changes\n"
+        "                        in watch mode, 50 ms by default\n"
+        "  --lsp                 run a language server formatting the documents\n"
+        "                        open in an editor, over stdin and stdout\n"
+        "  --max-time=MS         skip a file not formatted within MS milliseconds\n"
+        "  --max-bytes=N         skip files larger than N bytes\n"
+        "  --max-lines=N         skip files longer than N lines\n"
+        "  --max-depth=N         skip files indented deeper than N levels\n"
+        "  --stats               print formatting statistics to stderr\n"
+        "  --trace=FILE          write a timeline of the work done by every\n"
+        "                        thread in the Chrome trace event format\n"
+        "\n"
+        "Without -i, --diff or --edits a single file is formatted to stdout.\n"
+        "Directories are walked recursively, honouring .gitignore and\n"
+        ".code-formatter-ignore files. The formatting options are read from\n"
+        ".code-formatter files found in the directory of each formatted file\n"
+        "and its parents. A skipped file is reported and left unchanged, it is\n"
+        "printed as it is when writing to stdout.\n";
+}
+
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <config/ConfigParser.hpp>
+
+#include <FileContent.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+namespace config
+{
+
+namespace
+{
+
+std::string_view
+strip(std::string_view text)
+{
+    while (not text.empty() and (is_white_char(text.front()) or text.front() == '\r')) {
+        text.remove_prefix(1);
+    }
+    while (not text.empty() and (is_white_char(text.back()) or text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+
+[[noreturn]] void
+throwError(const std::size_t line_number, const std::string &message)
+{
+    throw ConfigError("line " + std::to_string(line_number) + ": " + message);
+}
+
+
+bool
+parseBool(const std::string_view value, const std::size_t line_number)
+{
+    if (value == "true") {
+        return true;
+    }
+    if (value == "false") {
+        return false;
+    }
+
+    throwError(line_number, "expected true or false, got: " + std::string(value));
+}
+
+
+int
+parseInt(const std::string_view value, const std::size_t line_number)
+{
+    const bool is_number = not value.empty()
+                           and std::all_of(value.begin(), value.end(), [](char c) {
+                               return c >= '0' and c <= '9';
+                           });
+    if (not is_number or value.size() > 4) {
+        throwError(line_number, "expected a number, got: " + std::string(value));
+    }
+
+    return std::stoi(std::string(value));
+}
+
+
+std::set<char>
+parseCharSet(const std::string_view value)
+{
+    std::set<char> chars;
+    for (const char c : value) {
+        if (not is_white_char(c)) {
+            chars.insert(c);
+        }
+    }
+
+    return chars;
+}
+
+
+std::vector<std::string>
+parseWordList(std::string_view value)
+{
+    std::vector<std::string> words;
+    while (not value.empty()) {
+        const auto word_end = std::find_if(value.begin(), value.end(), is_white_char);
+        const auto word_size = static_cast<std::size_t>(std::distance(value.begin(), word_end));
+        if (word_size > 0) {
+            words.emplace_back(value.substr(0, word_size));
+        }
+        value.remove_prefix(std::min(word_size + 1, value.size()));
+    }
+
+    return words;
+}
+
+}
+
+
+ParsedConfig
+parseConfig(std::string_view content, formatter::FormatterOptions &options)
+{
+    ParsedConfig parsed;
+    std::size_t line_number = 0;
+
+    while (not content.empty()) {
+        ++line_number;
+
+        auto line_end = content.find('\n');
+        if (line_end == std::string_view::npos) {
+            line_end = content.size();
+        }
+        const auto line = strip(content.substr(0, line_end));
+        content.remove_prefix(std::min(line_end + 1, content.size()));
+
+        if (line.empty() or line.front() == '#') {
+            continue;
+        }
+
+        const auto separator_pos = line.find('=');
+        if (separator_pos == std::string_view::npos) {
+            throwError(line_number, "expected key = value");
+        }
+
+        const auto key = strip(line.substr(0, separator_pos));
+        const auto value = strip(line.substr(separator_pos + 1));
+        auto &indentation = options.indentation;
+        auto &split = options.split;
+
+        if (key == "root") {
+            parsed.is_root = parseBool(value, line_number);
+        }
+        else if (key == "increase_indentation_chars") {
+            indentation.increase_indentation_chars = parseCharSet(value);
+        }
+        else if (key == "decrease_indentation_chars") {
+            indentation.decrease_indentation_chars = parseCharSet(value);
+        }
+        else if (key == "increase_indentation_keywords") {
+            indentation.increase_indentation_keywords = parseWordList(value);
+        }
+        else if (key == "decrease_indentation_keywords") {
+            indentation.decrease_indentation_keywords = parseWordList(value);
+        }
+        else if (key == "num_of_spaces") {
+            indentation.num_of_spaces = parseInt(value, line_number);
+        }
+        else if (key == "reduce_indent_for_last_decrease_char") {
+            indentation.reduce_indent_for_last_decrease_char = parseBool(value, line_number);
+        }
+        else if (key == "progressive_indent") {
+            indentation.progressive_indent = parseBool(value, line_number);
+        }
+        else if (key == "split_after_chars") {
+            split.split_after_chars = parseCharSet(value);
+        }
+        else if (key == "split_before_chars") {
+            split.split_before_chars = parseCharSet(value);
+        }
+        else if (key == "keep_trailing_delimiter") {
+            split.keep_trailing_delimiter = parseBool(value, line_number);
+        }
+        else if (key == "keep_delimiter_runs") {
+            split.keep_delimiter_runs = parseBool(value, line_number);
+        }
+        else {
+            throwError(line_number, "unknown option: " + std::string(key));
+        }
+    }
+
+    return parsed;
+}
+
+}
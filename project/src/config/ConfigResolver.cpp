@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <config/ConfigResolver.hpp>
+#include <config/ConfigParser.hpp>
+
+#include <mutex>
+#include <utility>
+
+
+namespace config
+{
+
+namespace
+{
+
+ConfigResolver::ResolvedOptions
+compileOptions(ConfigResolver::OptionsPtr options)
+{
+    auto keyword_matcher = formatter::detail::KeywordMatcher::compile(options->indentation);
+    return {std::move(options), std::move(keyword_matcher)};
+}
+
+}
+
+
+ConfigResolver::ConfigResolver(formatter::FormatterOptions default_options,
+                               FileSystem &file_system,
+                               std::string config_file_name)
+    : default_options_(compileOptions(std::make_shared<const formatter::FormatterOptions>(std::move(default_options)))),
+      file_system_(file_system),
+      config_file_name_(std::move(config_file_name))
+{
+}
+
+
+ConfigResolver::ResolvedOptions
+ConfigResolver::resolveFile(const std::filesystem::path &file)
+{
+    const auto normalized_file = std::filesystem::absolute(file).lexically_normal();
+    return resolveDirectory(normalized_file.parent_path());
+}
+
+
+ConfigResolver::ResolvedOptions
+ConfigResolver::resolveDirectory(const std::filesystem::path &directory)
+{
+    auto normalized_directory = std::filesystem::absolute(directory).lexically_normal();
+    if (not normalized_directory.has_filename() and normalized_directory.has_relative_path()) {
+        normalized_directory = normalized_directory.parent_path();
+    }
+
+    return resolve(normalized_directory);
+}
+
+
+ConfigResolver::OptionsPtr
+ConfigResolver::optionsForFile(const std::filesystem::path &file)
+{
+    return resolveFile(file).options;
+}
+
+
+ConfigResolver::OptionsPtr
+ConfigResolver::optionsForDirectory(const std::filesystem::path &directory)
+{
+    return resolveDirectory(directory).options;
+}
+
+
+std::optional<ConfigResolver::ResolvedOptions>
+ConfigResolver::findCached(const std::string &key)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto cached_it = cache_.find(key);
+    if (cached_it != cache_.end()) {
+        return cached_it->second;
+    }
+
+    return std::nullopt;
+}
+
+
+/*
+ * The config files are read, parsed and compiled without the lock, so the
+ * threads resolving other directories do not wait for them. Threads
+ * resolving the same directory at once may both read it, the options
+ * cached first are used by all of them. A directory without a config file
+ * shares the options and the automaton of its parent.
+ */
+ConfigResolver::ResolvedOptions
+ConfigResolver::resolve(const std::filesystem::path &directory)
+{
+    const auto key = directory.string();
+    if (auto cached_options = findCached(key)) {
+        return *cached_options;
+    }
+
+    const bool has_parent = directory.has_relative_path();
+    auto options = has_parent ? resolve(directory.parent_path()) : default_options_;
+
+    const auto config_path = directory / config_file_name_;
+    if (const auto content = file_system_.readFile(config_path)) {
+        try {
+            auto parsed_options = *options.options;
+            if (parseConfig(*content, parsed_options).is_root) {
+                parsed_options = *default_options_.options;
+                parseConfig(*content, parsed_options);
+            }
+            options = compileOptions(std::make_shared<const formatter::FormatterOptions>(std::move(parsed_options)));
+        }
+        catch (const ConfigError &e) {
+            throw ConfigError(config_path.string() + ": " + e.what());
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return cache_.emplace(key, std::move(options)).first->second;
+}
+
+}
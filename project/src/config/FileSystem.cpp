@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <config/FileSystem.hpp>
+
+#include <fstream>
+#include <iterator>
+
+
+namespace config
+{
+
+std::optional<std::string>
+LocalFileSystem::readFile(const std::filesystem::path &path)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (not f.is_open()) {
+        return std::nullopt;
+    }
+
+    return std::string(std::istreambuf_iterator<char>(f),
+                       std::istreambuf_iterator<char>());
+}
+
+}
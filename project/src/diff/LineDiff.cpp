@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <diff/LineDiff.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+
+
+namespace diff
+{
+
+namespace
+{
+
+constexpr long min_cost_limit = 256;
+
+
+struct HashedLine
+{
+    std::size_t hash;
+    std::string_view text;
+    std::size_t index;
+
+    bool operator==(const HashedLine &other) const
+    {
+        return hash == other.hash
+            and text == other.text;
+    }
+};
+
+
+/*
+ * Open addressing set of line hashes. Equal hashes of different lines
+ * only keep a line in the search, so the text is not compared here.
+ */
+class HashSet
+{
+public:
+    explicit HashSet(const std::vector<HashedLine> &lines)
+        : mask_(bucketCount(lines.size()) - 1),
+          buckets_(mask_ + 1, empty_bucket)
+    {
+        for (const auto &line : lines) {
+            auto bucket = line.hash & mask_;
+            while (buckets_[bucket] != empty_bucket and buckets_[bucket] != line.hash) {
+                bucket = (bucket + 1) & mask_;
+            }
+            buckets_[bucket] = line.hash;
+        }
+    }
+
+    bool contains(const std::size_t hash) const
+    {
+        auto bucket = hash & mask_;
+        while (buckets_[bucket] != empty_bucket) {
+            if (buckets_[bucket] == hash) {
+                return true;
+            }
+            bucket = (bucket + 1) & mask_;
+        }
+
+        return false;
+    }
+
+private:
+    static constexpr std::size_t empty_bucket = 0;
+
+    static std::size_t bucketCount(const std::size_t size)
+    {
+        std::size_t count = 16;
+        while (count < 2 * size) {
+            count *= 2;
+        }
+
+        return count;
+    }
+
+    std::size_t mask_;
+    std::vector<std::size_t> buckets_;
+};
+
+
+/*
+ * The empty bucket marker is zero, so the hashes are never zero.
+ */
+std::vector<HashedLine>
+hashLines(const std::vector<std::string_view> &lines, const std::size_t begin, const std::size_t end)
+{
+    std::vector<HashedLine> hashed_lines;
+    hashed_lines.reserve(end - begin);
+    for (auto i = begin; i < end; ++i) {
+        const auto hash = std::hash<std::string_view>{}(lines[i]) | 1;
+        hashed_lines.push_back(HashedLine{hash, lines[i], i});
+    }
+
+    return hashed_lines;
+}
+
+
+/*
+ * Lines without a match in the other file can not be a part of the
+ * common subsequence, so they are marked as changed up front and only
+ * the remaining lines are searched. Reindented lines usually have no
+ * match at all, which keeps the search small.
+ */
+std::vector<HashedLine>
+discardUnmatchedLines(const std::vector<HashedLine> &lines,
+                      const HashSet &other_lines,
+                      std::vector<bool> &changed)
+{
+    std::vector<HashedLine> matched_lines;
+    matched_lines.reserve(lines.size());
+    for (const auto &line : lines) {
+        if (other_lines.contains(line.hash)) {
+            matched_lines.push_back(line);
+        }
+        else {
+            changed[line.index] = true;
+        }
+    }
+
+    return matched_lines;
+}
+
+
+class Myers
+{
+public:
+    Myers(const std::vector<HashedLine> &a, const std::vector<HashedLine> &b, LineDiff &result)
+        : a_(a),
+          b_(b),
+          result_(result),
+          forward_(a.size() + b.size() + 3),
+          backward_(a.size() + b.size() + 3),
+          cost_limit_(std::max(min_cost_limit,
+                               static_cast<long>(std::sqrt(static_cast<double>(a.size() + b.size())))))
+    {
+    }
+
+    void compare(long a_begin, long a_end, long b_begin, long b_end)
+    {
+        while (a_begin < a_end and b_begin < b_end and a_[a_begin] == b_[b_begin]) {
+            ++a_begin;
+            ++b_begin;
+        }
+        while (a_begin < a_end and b_begin < b_end and a_[a_end - 1] == b_[b_end - 1]) {
+            --a_end;
+            --b_end;
+        }
+
+        if (a_begin == a_end or b_begin == b_end) {
+            markChanged(a_begin, a_end, b_begin, b_end);
+            return;
+        }
+
+        long split_a;
+        long split_b;
+        if (not findMiddleSnake(a_begin, a_end, b_begin, b_end, split_a, split_b)) {
+            markChanged(a_begin, a_end, b_begin, b_end);
+            return;
+        }
+
+        compare(a_begin, split_a, b_begin, split_b);
+        compare(split_a, a_end, split_b, b_end);
+    }
+
+private:
+    void markChanged(const long a_begin, const long a_end, const long b_begin, const long b_end)
+    {
+        for (auto i = a_begin; i < a_end; ++i) {
+            result_.removed[a_[i].index] = true;
+        }
+        for (auto i = b_begin; i < b_end; ++i) {
+            result_.added[b_[i].index] = true;
+        }
+    }
+
+    /*
+     * Searches the furthest reaching paths from both ends at once and
+     * returns the point where they meet, so both halves can be compared
+     * separately in the same memory. When no meeting point is found
+     * within the cost limit, the furthest reaching forward path is used
+     * instead, trading the minimal result for bounded time.
+     */
+    bool findMiddleSnake(const long a_begin, const long a_end, const long b_begin, const long b_end,
+                         long &split_a, long &split_b)
+    {
+        const long n = a_end - a_begin;
+        const long m = b_end - b_begin;
+        const long max_d = (n + m + 1) / 2;
+        const long v_offset = max_d;
+        const long v_length = 2 * max_d + 2;
+
+        std::fill_n(forward_.begin(), v_length, -1);
+        std::fill_n(backward_.begin(), v_length, -1);
+        forward_[v_offset + 1] = 0;
+        backward_[v_offset + 1] = 0;
+
+        const long delta = n - m;
+        const bool is_delta_odd = delta % 2 != 0;
+        long k1_start = 0;
+        long k1_end = 0;
+        long k2_start = 0;
+        long k2_end = 0;
+
+        for (long d = 0; d < max_d; ++d) {
+            for (long k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2) {
+                const long k1_offset = v_offset + k1;
+                long x1;
+                if (k1 == -d or (k1 != d and forward_[k1_offset - 1] < forward_[k1_offset + 1])) {
+                    x1 = forward_[k1_offset + 1];
+                }
+                else {
+                    x1 = forward_[k1_offset - 1] + 1;
+                }
+                long y1 = x1 - k1;
+                while (x1 < n and y1 < m and a_[a_begin + x1] == b_[b_begin + y1]) {
+                    ++x1;
+                    ++y1;
+                }
+                forward_[k1_offset] = x1;
+
+                if (x1 > n) {
+                    k1_end += 2;
+                }
+                else if (y1 > m) {
+                    k1_start += 2;
+                }
+                else if (is_delta_odd) {
+                    const long k2_offset = v_offset + delta - k1;
+                    if (k2_offset >= 0 and k2_offset < v_length and backward_[k2_offset] != -1) {
+                        if (x1 >= n - backward_[k2_offset]) {
+                            split_a = a_begin + x1;
+                            split_b = b_begin + y1;
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            for (long k2 = -d + k2_start; k2 <= d - k2_end; k2 += 2) {
+                const long k2_offset = v_offset + k2;
+                long x2;
+                if (k2 == -d or (k2 != d and backward_[k2_offset - 1] < backward_[k2_offset + 1])) {
+                    x2 = backward_[k2_offset + 1];
+                }
+                else {
+                    x2 = backward_[k2_offset - 1] + 1;
+                }
+                long y2 = x2 - k2;
+                while (x2 < n and y2 < m and a_[a_end - x2 - 1] == b_[b_end - y2 - 1]) {
+                    ++x2;
+                    ++y2;
+                }
+                backward_[k2_offset] = x2;
+
+                if (x2 > n) {
+                    k2_end += 2;
+                }
+                else if (y2 > m) {
+                    k2_start += 2;
+                }
+                else if (not is_delta_odd) {
+                    const long k1_offset = v_offset + delta - k2;
+                    if (k1_offset >= 0 and k1_offset < v_length and forward_[k1_offset] != -1) {
+                        const long x1 = forward_[k1_offset];
+                        const long y1 = v_offset + x1 - k1_offset;
+                        if (x1 >= n - x2) {
+                            split_a = a_begin + x1;
+                            split_b = b_begin + y1;
+                            return true;
+                        }
+                    }
+                }
+            }
+
+            if (d >= cost_limit_) {
+                long best_x = 0;
+                long best_y = 0;
+                for (long k1 = -d + k1_start; k1 <= d - k1_end; k1 += 2) {
+                    const long x1 = std::min(forward_[v_offset + k1], n);
+                    const long y1 = x1 - k1;
+                    if (y1 >= 0 and y1 <= m and x1 + y1 > best_x + best_y) {
+                        best_x = x1;
+                        best_y = y1;
+                    }
+                }
+                if (best_x + best_y > 0 and best_x + best_y < n + m) {
+                    split_a = a_begin + best_x;
+                    split_b = b_begin + best_y;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    const std::vector<HashedLine> &a_;
+    const std::vector<HashedLine> &b_;
+    LineDiff &result_;
+    std::vector<long> forward_;
+    std::vector<long> backward_;
+    const long cost_limit_;
+};
+
+}
+
+
+LineDiff
+diffLines(const std::vector<std::string_view> &original,
+          const std::vector<std::string_view> &modified)
+{
+    LineDiff result;
+    result.removed.assign(original.size(), false);
+    result.added.assign(modified.size(), false);
+
+    const auto common_size = std::min(original.size(), modified.size());
+    std::size_t prefix = 0;
+    while (prefix < common_size and original[prefix] == modified[prefix]) {
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while (suffix < common_size - prefix
+           and original[original.size() - suffix - 1] == modified[modified.size() - suffix - 1]) {
+        ++suffix;
+    }
+
+    const auto hashed_original = hashLines(original, prefix, original.size() - suffix);
+    const auto hashed_modified = hashLines(modified, prefix, modified.size() - suffix);
+    const HashSet original_set(hashed_original);
+    const HashSet modified_set(hashed_modified);
+
+    const auto matched_original = discardUnmatchedLines(hashed_original, modified_set, result.removed);
+    const auto matched_modified = discardUnmatchedLines(hashed_modified, original_set, result.added);
+
+    Myers myers(matched_original, matched_modified, result);
+    myers.compare(0, static_cast<long>(matched_original.size()), 0, static_cast<long>(matched_modified.size()));
+
+    return result;
+}
+
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <diff/UnifiedDiff.hpp>
+#include <diff/LineDiff.hpp>
+#include <io/FileWriter.hpp>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+
+namespace diff
+{
+
+namespace
+{
+
+constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+constexpr std::string_view no_newline_marker = "\\ No newline at end of file\n";
+
+
+std::vector<std::string_view>
+lineViews(const FileContent &content)
+{
+    return std::vector<std::string_view>(content.begin(), content.end());
+}
+
+
+/*
+ * Without the final newline the last line differs from the same text in
+ * the middle of the other file, so such a pair is turned into a change.
+ */
+void
+markUnterminatedLastLine(LineDiff &line_diff)
+{
+    const auto original_size = line_diff.removed.size();
+    const auto formatted_size = line_diff.added.size();
+    std::size_t i = 0;
+    std::size_t j = 0;
+
+    while (i < original_size and j < formatted_size) {
+        if (line_diff.removed[i]) {
+            ++i;
+        }
+        else if (line_diff.added[j]) {
+            ++j;
+        }
+        else {
+            if ((i + 1 == original_size) != (j + 1 == formatted_size)) {
+                line_diff.removed[i] = true;
+                line_diff.added[j] = true;
+            }
+            ++i;
+            ++j;
+        }
+    }
+}
+
+
+struct Hunk
+{
+    std::size_t original_begin;
+    std::size_t original_end;
+    std::size_t formatted_begin;
+    std::size_t formatted_end;
+};
+
+
+/*
+ * Groups the changed lines into hunks, merging changes which are closer
+ * than twice the context, the same way diff -u does.
+ */
+std::vector<Hunk>
+collectHunks(const LineDiff &line_diff, const std::size_t context_lines)
+{
+    std::vector<Hunk> hunks;
+    const auto original_size = line_diff.removed.size();
+    const auto formatted_size = line_diff.added.size();
+    std::size_t i = 0;
+    std::size_t j = 0;
+
+    while (i < original_size or j < formatted_size) {
+        if ((i < original_size and line_diff.removed[i])
+            or (j < formatted_size and line_diff.added[j])) {
+            const auto change_i = i;
+            const auto change_j = j;
+            while (i < original_size and line_diff.removed[i]) {
+                ++i;
+            }
+            while (j < formatted_size and line_diff.added[j]) {
+                ++j;
+            }
+
+            const auto context_before = std::min({context_lines, change_i, change_j});
+            if (not hunks.empty()
+                and hunks.back().original_end + context_lines >= change_i - context_before) {
+                hunks.back().original_end = i;
+                hunks.back().formatted_end = j;
+            }
+            else {
+                if (not hunks.empty()) {
+                    hunks.back().original_end += context_lines;
+                    hunks.back().formatted_end += context_lines;
+                }
+                hunks.push_back(Hunk{change_i - context_before, i, change_j - context_before, j});
+            }
+        }
+        else {
+            ++i;
+            ++j;
+        }
+    }
+
+    if (not hunks.empty()) {
+        hunks.back().original_end = std::min(hunks.back().original_end + context_lines, original_size);
+        hunks.back().formatted_end = std::min(hunks.back().formatted_end + context_lines, formatted_size);
+    }
+
+    return hunks;
+}
+
+
+void
+appendRange(std::string &output, const std::size_t begin, const std::size_t end)
+{
+    const auto count = end - begin;
+    output += std::to_string(count == 0 ? begin : begin + 1);
+    if (count != 1) {
+        output += ',';
+        output += std::to_string(count);
+    }
+}
+
+
+class HunkWriter
+{
+public:
+    HunkWriter(std::string &output,
+               const std::vector<std::string_view> &original,
+               const std::vector<std::string_view> &formatted,
+               const io::TextFormat &format)
+        : output_(output),
+          original_(original),
+          formatted_(formatted),
+          format_(format),
+          line_ending_(io::lineEndingChars(format.line_ending))
+    {
+    }
+
+    void writeOriginal(const char prefix, const std::size_t index)
+    {
+        writeLine(prefix, original_, index);
+    }
+
+    void writeFormatted(const char prefix, const std::size_t index)
+    {
+        writeLine(prefix, formatted_, index);
+    }
+
+private:
+    void writeLine(const char prefix, const std::vector<std::string_view> &lines, const std::size_t index)
+    {
+        output_ += prefix;
+        if (index == 0 and format_.has_bom) {
+            output_ += utf8_bom;
+        }
+        output_ += lines[index];
+
+        if (index + 1 == lines.size() and not format_.ends_with_newline) {
+            output_ += '\n';
+            output_ += no_newline_marker;
+        }
+        else {
+            output_ += line_ending_;
+        }
+    }
+
+    std::string &output_;
+    const std::vector<std::string_view> &original_;
+    const std::vector<std::string_view> &formatted_;
+    const io::TextFormat &format_;
+    const std::string_view line_ending_;
+};
+
+}
+
+
+std::string
+unifiedDiff(const FileContent &original,
+            const FileContent &formatted,
+            const io::TextFormat &format,
+            const std::string &original_label,
+            const std::string &formatted_label,
+            const std::size_t context_lines)
+{
+    const auto original_lines = lineViews(original);
+    const auto formatted_lines = lineViews(formatted);
+    auto line_diff = diffLines(original_lines, formatted_lines);
+    if (not format.ends_with_newline) {
+        markUnterminatedLastLine(line_diff);
+    }
+    const auto hunks = collectHunks(line_diff, context_lines);
+
+    std::string output;
+    if (hunks.empty()) {
+        return output;
+    }
+
+    output += "--- " + original_label + "\n";
+    output += "+++ " + formatted_label + "\n";
+
+    HunkWriter writer(output, original_lines, formatted_lines, format);
+    for (const auto &hunk : hunks) {
+        output += "@@ -";
+        appendRange(output, hunk.original_begin, hunk.original_end);
+        output += " +";
+        appendRange(output, hunk.formatted_begin, hunk.formatted_end);
+        output += " @@\n";
+
+        auto i = hunk.original_begin;
+        auto j = hunk.formatted_begin;
+        while (i < hunk.original_end or j < hunk.formatted_end) {
+            if (i < hunk.original_end and line_diff.removed[i]) {
+                writer.writeOriginal('-', i++);
+            }
+            else if (j < hunk.formatted_end and line_diff.added[j]) {
+                writer.writeFormatted('+', j++);
+            }
+            else {
+                writer.writeOriginal(' ', i++);
+                ++j;
+            }
+        }
+    }
+
+    return output;
+}
+
+}
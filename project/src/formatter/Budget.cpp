@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/Budget.hpp>
+
+#include <limits>
+#include <string>
+
+
+namespace formatter
+{
+
+namespace
+{
+
+constexpr auto unlimited = std::numeric_limits<std::size_t>::max();
+
+
+std::size_t
+limitOrUnlimited(const std::size_t limit)
+{
+    return limit == 0 ? unlimited : limit;
+}
+
+
+std::string
+limitMessage(const BudgetExceededError::Limit limit, const std::size_t value)
+{
+    switch (limit) {
+    case BudgetExceededError::Limit::Time:
+        return "time limit of " + std::to_string(value) + " ms exceeded";
+    case BudgetExceededError::Limit::Bytes:
+        return "limit of " + std::to_string(value) + " bytes exceeded";
+    case BudgetExceededError::Limit::Lines:
+        return "limit of " + std::to_string(value) + " lines exceeded";
+    case BudgetExceededError::Limit::IndentationDepth:
+        return "indentation depth limit of " + std::to_string(value) + " exceeded";
+    }
+
+    return "limit exceeded";
+}
+
+}
+
+
+BudgetExceededError::BudgetExceededError(const Limit limit, const std::size_t value)
+    : std::runtime_error(limitMessage(limit, value)),
+      limit_(limit)
+{
+}
+
+
+BudgetExceededError::Limit
+BudgetExceededError::limit() const noexcept
+{
+    return limit_;
+}
+
+
+bool
+hasLimits(const FormatLimits &limits) noexcept
+{
+    return limits.time.count() > 0
+        or limits.bytes > 0
+        or limits.lines > 0
+        or limits.indentation_depth > 0;
+}
+
+
+Budget::Budget(const FormatLimits &limits)
+    : lines_limit_(limitOrUnlimited(limits.lines)),
+      bytes_limit_(limitOrUnlimited(limits.bytes)),
+      indentation_depth_limit_(limitOrUnlimited(limits.indentation_depth)),
+      time_limit_(limits.time),
+      deadline_(std::chrono::steady_clock::now() + limits.time)
+{
+}
+
+
+void
+Budget::checkInputSize(const std::size_t bytes) const
+{
+    if (bytes > bytes_limit_) {
+        throw BudgetExceededError(BudgetExceededError::Limit::Bytes, bytes_limit_);
+    }
+}
+
+
+/*
+ * The clock is read once per a few lines, the check is then cheap enough
+ * for every line.
+ */
+void
+Budget::checkLimits()
+{
+    if (lines_ > lines_limit_) {
+        throw BudgetExceededError(BudgetExceededError::Limit::Lines, lines_limit_);
+    }
+    if (bytes_ > bytes_limit_) {
+        throw BudgetExceededError(BudgetExceededError::Limit::Bytes, bytes_limit_);
+    }
+
+    lines_to_clock_check_ = clock_check_lines;
+    if (time_limit_.count() > 0 and std::chrono::steady_clock::now() > deadline_) {
+        throw BudgetExceededError(BudgetExceededError::Limit::Time, static_cast<std::size_t>(time_limit_.count()));
+    }
+}
+
+}
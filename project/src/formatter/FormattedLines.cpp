@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/FormattedLines.hpp>
+#include <formatter/detail/FormatLine.hpp>
+
+#include <algorithm>
+
+
+namespace formatter
+{
+
+FormattedLines::Iterator::Iterator(FormattedLines *lines)
+    : lines_(lines)
+{
+}
+
+
+FormattedLines::Iterator::reference
+FormattedLines::Iterator::operator*() const
+{
+    return lines_->pending_lines_.front();
+}
+
+
+FormattedLines::Iterator::pointer
+FormattedLines::Iterator::operator->() const
+{
+    return &lines_->pending_lines_.front();
+}
+
+
+FormattedLines::Iterator&
+FormattedLines::Iterator::operator++()
+{
+    lines_->next();
+    return *this;
+}
+
+
+void
+FormattedLines::Iterator::operator++(int)
+{
+    lines_->next();
+}
+
+
+bool
+FormattedLines::Iterator::operator==(const Iterator &other) const
+{
+    if (isEnd() or other.isEnd()) {
+        return isEnd() == other.isEnd();
+    }
+
+    return lines_ == other.lines_;
+}
+
+
+bool
+FormattedLines::Iterator::operator!=(const Iterator &other) const
+{
+    return not (*this == other);
+}
+
+
+bool
+FormattedLines::Iterator::isEnd() const
+{
+    return lines_ == nullptr or lines_->pending_lines_.empty();
+}
+
+
+FormattedLines::FormattedLines(const std::string_view normalized_text, const FormatterOptions &options)
+    : remaining_text_(normalized_text),
+      splitter_(options.split),
+      indenter_(options.indentation)
+{
+}
+
+
+FormattedLines::Iterator
+FormattedLines::begin()
+{
+    if (pending_lines_.empty()) {
+        fillPendingLines();
+    }
+
+    return Iterator(this);
+}
+
+
+FormattedLines::Iterator
+FormattedLines::end()
+{
+    return Iterator();
+}
+
+
+/*
+ * Lines are cut the same way io::splitLines does, a line break ending
+ * the text does not start another line.
+ */
+void
+FormattedLines::fillPendingLines()
+{
+    if (remaining_text_.empty()) {
+        return;
+    }
+
+    auto line_end = remaining_text_.find('\n');
+    if (line_end == std::string_view::npos) {
+        line_end = remaining_text_.size();
+    }
+
+    detail::formatLine(remaining_text_.substr(0, line_end), splitter_, indenter_, pending_lines_);
+    remaining_text_.remove_prefix(std::min(line_end + 1, remaining_text_.size()));
+}
+
+
+void
+FormattedLines::next()
+{
+    pending_lines_.pop_front();
+    if (pending_lines_.empty()) {
+        fillPendingLines();
+    }
+}
+
+}
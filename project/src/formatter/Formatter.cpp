@@ -7,17 +7,75 @@
  */
 
 #include <formatter/Formatter.hpp>
-#include <formatter/detail/InsertNewLineAfterChar.hpp>
+#include <formatter/detail/FormatLine.hpp>
 #include <formatter/detail/UpdateIndentation.hpp>
 
+#include <iterator>
+#include <optional>
+#include <utility>
+
 namespace formatter
 {
 
+namespace
+{
+
+std::optional<Budget>
+budgetFor(const FormatterOptions &options)
+{
+    if (hasLimits(options.limits)) {
+        return Budget(options.limits);
+    }
+
+    return std::nullopt;
+}
+
+}
+
+
+FormatStatistics
+format(FileContent &content, const FormatterOptions &options,
+       detail::KeywordMatcherPtr keyword_matcher)
+{
+    const detail::Splitter splitter(options.split);
+    detail::Indenter indenter(options.indentation, std::move(keyword_matcher), content.get_allocator().resource());
+    auto budget = budgetFor(options);
+    return detail::formatLines(content, splitter, indenter, budget ? &*budget : nullptr);
+}
+
+
 void
-format(FileContent &content, const FormatterOptions &options)
+format(FileContent &content, const FormatterOptions &options,
+       const std::vector<LineRange> &line_ranges,
+       detail::KeywordMatcherPtr keyword_matcher)
 {
-    detail::insertNewLineAfterChar(content, ';');
-    detail::updateIndentation(content, options.indentation);
+    const detail::Splitter splitter(options.split);
+    detail::Indenter indenter(options.indentation, std::move(keyword_matcher), content.get_allocator().resource());
+    FileContent formatted_lines(content.get_allocator());
+    auto budget = budgetFor(options);
+    auto range_it = line_ranges.cbegin();
+    std::size_t line_number = 0;
+
+    for (auto line_it = content.begin(); line_it != content.end(); ++line_it) {
+        ++line_number;
+        while (range_it != line_ranges.cend() and range_it->last < line_number) {
+            ++range_it;
+        }
+
+        const bool is_selected = range_it != line_ranges.cend()
+                                 and range_it->first <= line_number;
+
+        detail::formatLine(*line_it, splitter, indenter, formatted_lines, budget ? &*budget : nullptr);
+
+        if (is_selected) {
+            content.splice(line_it, formatted_lines);
+            line_it = content.erase(line_it);
+            --line_it;
+        }
+        else {
+            formatted_lines.clear();
+        }
+    }
 }
 
 }
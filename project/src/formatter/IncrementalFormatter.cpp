@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/IncrementalFormatter.hpp>
+#include <formatter/detail/FormatLine.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+
+namespace formatter
+{
+
+IncrementalFormatter::IncrementalFormatter(const FormatterOptions &options,
+                                           detail::KeywordMatcherPtr keyword_matcher)
+    : options_(options),
+      splitter_(options.split),
+      final_indenter_(options.indentation, std::move(keyword_matcher))
+{
+}
+
+
+FileContent
+IncrementalFormatter::format(const FileContent &content)
+{
+    std::vector<const Line*> input;
+    input.reserve(content.size());
+    for (const auto &line : content) {
+        input.push_back(&line);
+    }
+
+    std::size_t common_prefix = 0;
+    while (common_prefix < input.size()
+           and common_prefix < lines_.size()
+           and *input[common_prefix] == lines_[common_prefix].input) {
+        ++common_prefix;
+    }
+
+    std::size_t common_suffix = 0;
+    while (common_suffix < input.size() - common_prefix
+           and common_suffix < lines_.size() - common_prefix
+           and *input[input.size() - common_suffix - 1] == lines_[lines_.size() - common_suffix - 1].input) {
+        ++common_suffix;
+    }
+
+    std::vector<LineState> lines;
+    lines.reserve(input.size());
+    std::move(lines_.begin(), std::next(lines_.begin(), common_prefix), std::back_inserter(lines));
+
+    auto indenter = common_prefix < lines_.size()
+                    ? lines_[common_prefix].indenter_before
+                    : final_indenter_;
+    bool is_suffix_reused = false;
+
+    const auto old_suffix_begin = lines_.size() - common_suffix;
+    last_formatted_begin_ = common_prefix;
+    last_formatted_lines_ = 0;
+
+    for (std::size_t i = common_prefix; i < input.size(); ++i) {
+        const bool is_in_suffix = i >= input.size() - common_suffix;
+        if (is_in_suffix) {
+            const auto old_index = old_suffix_begin + (i - (input.size() - common_suffix));
+            if (lines_[old_index].indenter_before == indenter) {
+                std::move(std::next(lines_.begin(), old_index), lines_.end(), std::back_inserter(lines));
+                is_suffix_reused = true;
+                break;
+            }
+        }
+
+        LineState state {*input[i], indenter, {}};
+        detail::formatLine(*input[i], splitter_, indenter, state.output);
+        lines.push_back(std::move(state));
+        ++last_formatted_lines_;
+    }
+
+    if (not is_suffix_reused) {
+        final_indenter_ = indenter;
+    }
+    lines_ = std::move(lines);
+
+    FileContent output;
+    for (const auto &line : lines_) {
+        output.insert(output.end(), line.output.cbegin(), line.output.cend());
+    }
+
+    return output;
+}
+
+
+void
+IncrementalFormatter::acceptOutput()
+{
+    const auto formatted_end = last_formatted_begin_ + last_formatted_lines_;
+
+    std::vector<LineState> lines;
+    lines.reserve(lines_.size());
+    std::move(lines_.begin(), std::next(lines_.begin(), last_formatted_begin_), std::back_inserter(lines));
+
+    for (auto i = last_formatted_begin_; i < formatted_end; ++i) {
+        auto indenter = lines_[i].indenter_before;
+        for (const auto &output_line : lines_[i].output) {
+            LineState state {output_line, indenter, {}};
+            detail::formatLine(output_line, splitter_, indenter, state.output);
+            lines.push_back(std::move(state));
+        }
+    }
+
+    std::move(std::next(lines_.begin(), formatted_end), lines_.end(), std::back_inserter(lines));
+
+    lines_ = std::move(lines);
+    last_formatted_begin_ = 0;
+    last_formatted_lines_ = 0;
+}
+
+
+std::size_t
+IncrementalFormatter::lastFormattedLines() const noexcept
+{
+    return last_formatted_lines_;
+}
+
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/TextEdits.hpp>
+#include <formatter/Budget.hpp>
+#include <formatter/detail/SplitLine.hpp>
+#include <formatter/detail/UpdateIndentation.hpp>
+
+#include <FileContent.hpp>
+#include <io/FileWriter.hpp>
+#include <io/InputNormalizer.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+
+namespace formatter
+{
+
+namespace
+{
+
+constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+
+
+/*
+ * Keeps only the differing middle of the replaced text, so e.g. a deeper
+ * indentation becomes an insertion of the missing spaces.
+ */
+void
+addEdit(std::vector<TextEdit> &edits, std::size_t offset, std::string_view original, std::string_view replacement)
+{
+    const auto common_prefix = static_cast<std::size_t>(
+        std::mismatch(original.cbegin(), original.cend(), replacement.cbegin(), replacement.cend()).first
+        - original.cbegin());
+    offset += common_prefix;
+    original.remove_prefix(common_prefix);
+    replacement.remove_prefix(common_prefix);
+
+    const auto common_suffix = static_cast<std::size_t>(
+        std::mismatch(original.crbegin(), original.crend(), replacement.crbegin(), replacement.crend()).first
+        - original.crbegin());
+    original.remove_suffix(common_suffix);
+    replacement.remove_suffix(common_suffix);
+
+    if (not original.empty() or not replacement.empty()) {
+        edits.push_back(TextEdit {offset, original.size(), std::string(replacement)});
+    }
+}
+
+
+std::size_t
+rawLineBreakSize(const std::string_view input, const std::size_t pos)
+{
+    if (pos >= input.size()) {
+        return 0;
+    }
+    if (input[pos] == '\r' and pos + 1 < input.size() and input[pos + 1] == '\n') {
+        return 2;
+    }
+
+    return 1;
+}
+
+}
+
+
+bool
+operator==(const TextEdit &lhs, const TextEdit &rhs)
+{
+    return lhs.offset == rhs.offset
+        and lhs.length == rhs.length
+        and lhs.replacement == rhs.replacement;
+}
+
+
+/*
+ * Every part of a split line is indented on its own copy, which gives
+ * the size of its new indentation. The part keeps its text after the
+ * leading white chars, so only those and the line break before the part
+ * are replaced.
+ */
+std::vector<TextEdit>
+formatEdits(const std::string_view input, const FormatterOptions &options,
+            detail::KeywordMatcherPtr keyword_matcher)
+{
+    const auto normalized = io::normalizeInput(input);
+    const auto line_ending = io::lineEndingChars(normalized.format.line_ending);
+    const std::string_view text = normalized.text;
+
+    const detail::Splitter splitter(options.split);
+    detail::Indenter indenter(options.indentation, std::move(keyword_matcher));
+
+    std::vector<TextEdit> edits;
+    std::vector<std::size_t> cuts;
+    Line part;
+    std::string replacement;
+
+    std::optional<Budget> budget;
+    if (hasLimits(options.limits)) {
+        budget.emplace(options.limits);
+    }
+
+    std::size_t raw_line_begin = normalized.format.has_bom ? utf8_bom.size() : 0;
+    std::size_t line_begin = 0;
+
+    while (line_begin < text.size()) {
+        const auto line_end = std::min(text.find('\n', line_begin), text.size());
+        const auto line = text.substr(line_begin, line_end - line_begin);
+        if (budget) {
+            budget->chargeLine(line.size());
+        }
+
+        cuts.clear();
+        splitter.findCuts(line, cuts);
+        cuts.push_back(line.size());
+
+        std::size_t part_begin = 0;
+        for (std::size_t i = 0; i < cuts.size(); ++i) {
+            const auto original_part = line.substr(part_begin, cuts[i] - part_begin);
+            part.assign(original_part);
+            const bool is_already_indented = indenter.updateLine(part);
+
+            if (i > 0 or not is_already_indented) {
+                const auto leading_chars = static_cast<std::size_t>(
+                    std::find_if_not(original_part.cbegin(), original_part.cend(), is_white_char)
+                    - original_part.cbegin());
+                const auto indentation_size = part.size() - (original_part.size() - leading_chars);
+
+                replacement.assign(i > 0 ? line_ending : std::string_view());
+                replacement.append(indentation_size, ' ');
+                addEdit(edits, raw_line_begin + part_begin, original_part.substr(0, leading_chars), replacement);
+            }
+
+            part_begin = cuts[i];
+        }
+
+        if (budget) {
+            budget->checkIndentationDepth(indenter.indentationLevel());
+        }
+
+        const auto raw_line_end = raw_line_begin + line.size();
+        const auto raw_line_break = input.substr(raw_line_end, rawLineBreakSize(input, raw_line_end));
+        if (not raw_line_break.empty() and raw_line_break != line_ending) {
+            addEdit(edits, raw_line_end, raw_line_break, line_ending);
+        }
+
+        raw_line_begin = raw_line_end + raw_line_break.size();
+        line_begin = line_end + 1;
+    }
+
+    return edits;
+}
+
+
+std::string
+applyEdits(const std::string_view text, const std::vector<TextEdit> &edits)
+{
+    std::string result;
+    std::size_t copied = 0;
+
+    for (const auto &edit : edits) {
+        result.append(text.substr(copied, edit.offset - copied));
+        result.append(edit.replacement);
+        copied = edit.offset + edit.length;
+    }
+    result.append(text.substr(copied));
+
+    return result;
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/detail/FormatLine.hpp>
+
+#include <iterator>
+
+
+namespace formatter::detail
+{
+
+void
+formatLine(const std::string_view input_line, const Splitter &splitter, Indenter &indenter, FileContent &output,
+           Budget *budget)
+{
+    if (budget) {
+        budget->chargeLine(input_line.size());
+    }
+
+    auto line_it = output.emplace(output.end(), input_line);
+    splitter.splitLine(output, line_it);
+
+    for (; line_it != output.end(); ++line_it) {
+        indenter.updateLine(*line_it);
+    }
+
+    if (budget) {
+        budget->checkIndentationDepth(indenter.indentationLevel());
+    }
+}
+
+
+/*
+ * Splits and indents every line in one pass. Lines which need neither
+ * are not modified, so already formatted content is only scanned.
+ */
+FormatStatistics
+formatLines(FileContent &content, const Splitter &splitter, Indenter &indenter, Budget *budget)
+{
+    FormatStatistics statistics;
+
+    for (auto line_it = content.begin(); line_it != content.end(); ++line_it) {
+        const auto input_size = line_it->size();
+        ++statistics.lines;
+        statistics.bytes += input_size;
+
+        if (budget) {
+            budget->chargeLine(input_size);
+        }
+
+        const auto inserted_lines = splitter.splitLine(content, line_it);
+        const bool is_already_indented = indenter.updateLine(*line_it);
+
+        if (is_already_indented and inserted_lines == 0) {
+            ++statistics.unchanged_lines;
+            statistics.unchanged_bytes += input_size;
+        }
+
+        for (std::size_t i = 0; i < inserted_lines; ++i) {
+            indenter.updateLine(*++line_it);
+        }
+
+        if (budget) {
+            budget->checkIndentationDepth(indenter.indentationLevel());
+        }
+    }
+
+    return statistics;
+}
+
+}
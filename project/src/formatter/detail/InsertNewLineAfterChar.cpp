@@ -7,6 +7,7 @@
  */
 
 #include <formatter/detail/InsertNewLineAfterChar.hpp>
+#include <formatter/detail/SplitLine.hpp>
 
 #include <algorithm>
 #include <iterator>
@@ -25,37 +26,34 @@ hasNonWhiteChar(const Line::const_iterator begin, const Line::const_iterator end
         return not is_white_char(character);});
 }
 
+}
 
-void
-insertLineAfter(FileContent &content, Line &&line, FileContent::iterator current_line_it)
+
+std::optional<Line>
+splitLineAfterChar(Line &line, char character)
 {
-    auto &next_line_it = current_line_it;
-    ++next_line_it;
-    content.insert(next_line_it, line);
-}
+    auto target_char_it = find(line.begin(), line.end(), character);
+    if (target_char_it != line.end()) {
+        auto after_target_char_it = target_char_it;
+        std::advance(after_target_char_it, 1);
+
+        if (hasNonWhiteChar(after_target_char_it, line.end())) {
+            Line new_line(after_target_char_it, line.end(), line.get_allocator());
+            line.erase(after_target_char_it, line.end());
+            return new_line;
+        }
+    }
 
+    return std::nullopt;
 }
 
 
 void
 insertNewLineAfterChar(FileContent &content, char character)
 {
-    for (auto current_line_it = content.begin(); current_line_it != content.end(); ++current_line_it) {
-        auto &current_line = *current_line_it;
-
-        auto target_char_it = find(current_line.begin(), current_line.end(), character);
-        if (target_char_it != current_line.end()) {
-            auto after_target_char_it = target_char_it;
-            std::advance(after_target_char_it, 1);
-
-            if (hasNonWhiteChar(after_target_char_it, current_line.end())) {
-                const auto split_pos = std::distance(current_line.begin(), after_target_char_it);
-                auto new_line = current_line.substr(split_pos);
-                current_line.erase(after_target_char_it, current_line.end());
-                insertLineAfter(content, std::move(new_line), current_line_it);
-            }
-        }
-    }
+    SplitOptions options;
+    options.split_after_chars = {character};
+    splitLines(content, options);
 }
 
 }
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/detail/KeywordMatcher.hpp>
+
+#include <deque>
+#include <string>
+
+
+namespace formatter::detail
+{
+
+/*
+ * The bytes of multibyte UTF-8 chars are word chars, so a keyword does not
+ * match inside a word written in another alphabet.
+ */
+bool
+is_word_char(const char c) noexcept
+{
+    const auto byte = static_cast<unsigned char>(c);
+    return (byte >= 'a' and byte <= 'z')
+        or (byte >= 'A' and byte <= 'Z')
+        or (byte >= '0' and byte <= '9')
+        or byte == '_'
+        or byte >= 0x80;
+}
+
+
+KeywordMatcher::KeywordMatcher(const IndentationOptions &options)
+    : states_(1)
+{
+    const auto increase_chars = std::string(options.increase_indentation_chars.cbegin(),
+                                            options.increase_indentation_chars.cend());
+    const auto decrease_chars = std::string(options.decrease_indentation_chars.cbegin(),
+                                            options.decrease_indentation_chars.cend());
+
+    addByteClasses(increase_chars);
+    addByteClasses(decrease_chars);
+    for (const auto *keywords : {&options.increase_indentation_keywords, &options.decrease_indentation_keywords}) {
+        for (const auto &keyword : *keywords) {
+            addByteClasses(keyword);
+        }
+    }
+    transitions_.assign(num_of_classes_, no_state);
+
+    for (const char &c : increase_chars) {
+        addTrigger(std::string_view(&c, 1), true, false);
+    }
+    for (const char &c : decrease_chars) {
+        addTrigger(std::string_view(&c, 1), false, false);
+    }
+    for (const auto &keyword : options.increase_indentation_keywords) {
+        addTrigger(keyword, true, true);
+    }
+    for (const auto &keyword : options.decrease_indentation_keywords) {
+        addTrigger(keyword, false, true);
+    }
+
+    compile();
+}
+
+
+bool
+KeywordMatcher::hasKeywords(const IndentationOptions &options) noexcept
+{
+    return not options.increase_indentation_keywords.empty()
+        or not options.decrease_indentation_keywords.empty();
+}
+
+
+std::shared_ptr<const KeywordMatcher>
+KeywordMatcher::compile(const IndentationOptions &options)
+{
+    if (hasKeywords(options)) {
+        return std::make_shared<const KeywordMatcher>(options);
+    }
+
+    return nullptr;
+}
+
+
+/*
+ * The bytes not used by any trigger share the class zero, so the table
+ * has a column only for the used ones.
+ */
+void
+KeywordMatcher::addByteClasses(const std::string_view trigger)
+{
+    for (const char c : trigger) {
+        auto &byte_class = byte_classes_[static_cast<unsigned char>(c)];
+        if (byte_class == 0) {
+            byte_class = static_cast<std::uint16_t>(num_of_classes_++);
+        }
+    }
+}
+
+
+/*
+ * The trie is built in the transition table, the missing transitions are
+ * filled in when the automaton is compiled.
+ */
+void
+KeywordMatcher::addTrigger(const std::string_view trigger, const bool increases, const bool is_keyword)
+{
+    if (trigger.empty()) {
+        return;
+    }
+
+    std::size_t state = 0;
+    for (const char c : trigger) {
+        const auto transition = state * num_of_classes_ + byte_classes_[static_cast<unsigned char>(c)];
+        if (transitions_[transition] == no_state) {
+            transitions_[transition] = static_cast<std::int32_t>(states_.size());
+            states_.emplace_back();
+            states_.back().length = states_[state].length + 1;
+            transitions_.resize(states_.size() * num_of_classes_, no_state);
+        }
+        state = static_cast<std::size_t>(transitions_[transition]);
+    }
+
+    auto &trigger_state = states_[state];
+    const bool needs_boundary_before = is_keyword and is_word_char(trigger.front());
+    const bool needs_boundary_after = is_keyword and is_word_char(trigger.back());
+    if (trigger_state.is_trigger) {
+        trigger_state.needs_boundary_before = trigger_state.needs_boundary_before and needs_boundary_before;
+        trigger_state.needs_boundary_after = trigger_state.needs_boundary_after and needs_boundary_after;
+    }
+    else {
+        trigger_state.needs_boundary_before = needs_boundary_before;
+        trigger_state.needs_boundary_after = needs_boundary_after;
+    }
+    trigger_state.is_trigger = true;
+    (increases ? trigger_state.increases : trigger_state.decreases) = true;
+}
+
+
+/*
+ * Walks the trie breadth first, so the failure state of every state is
+ * complete before its children take their transitions from it.
+ */
+void
+KeywordMatcher::compile()
+{
+    std::vector<std::size_t> failure(states_.size(), 0);
+    std::deque<std::size_t> queue;
+
+    for (std::size_t byte_class = 0; byte_class < num_of_classes_; ++byte_class) {
+        auto &next_state = transitions_[byte_class];
+        if (next_state == no_state) {
+            next_state = 0;
+        }
+        else {
+            queue.push_back(static_cast<std::size_t>(next_state));
+        }
+    }
+
+    while (not queue.empty()) {
+        const auto state = queue.front();
+        queue.pop_front();
+
+        for (std::size_t byte_class = 0; byte_class < num_of_classes_; ++byte_class) {
+            auto &next_state = transitions_[state * num_of_classes_ + byte_class];
+            const auto failure_next_state = transitions_[failure[state] * num_of_classes_ + byte_class];
+
+            if (next_state == no_state) {
+                next_state = failure_next_state;
+                continue;
+            }
+
+            const auto child = static_cast<std::size_t>(next_state);
+            const auto child_failure = static_cast<std::size_t>(failure_next_state);
+            failure[child] = child_failure;
+            states_[child].output_link = states_[child_failure].is_trigger
+                ? static_cast<std::int32_t>(child_failure)
+                : states_[child_failure].output_link;
+            queue.push_back(child);
+        }
+    }
+}
+
+
+bool
+KeywordMatcher::isAtBoundaries(const State &state, const std::string_view line,
+                               const std::size_t begin, const std::size_t end) const noexcept
+{
+    if (state.needs_boundary_before and begin > 0 and is_word_char(line[begin - 1])) {
+        return false;
+    }
+    if (state.needs_boundary_after and end < line.size() and is_word_char(line[end])) {
+        return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/detail/SplitLine.hpp>
+#include <formatter/detail/OperationCounter.hpp>
+
+#include <iterator>
+
+
+namespace formatter::detail
+{
+
+namespace
+{
+
+std::size_t
+findTextEnd(const std::string_view line, const std::size_t begin, std::size_t end)
+{
+    while (end > begin and is_white_char(line[end - 1])) {
+        --end;
+    }
+
+    return end;
+}
+
+}
+
+
+Splitter::Splitter(const SplitOptions &options)
+    : keep_trailing_delimiter_(options.keep_trailing_delimiter),
+      keep_delimiter_runs_(options.keep_delimiter_runs)
+{
+    for (const char character : options.split_after_chars) {
+        kinds_[static_cast<unsigned char>(character)] |= split_after;
+    }
+    for (const char character : options.split_before_chars) {
+        kinds_[static_cast<unsigned char>(character)] |= split_before;
+    }
+}
+
+
+template <typename Cut>
+void
+Splitter::forEachCut(const std::string_view line, Cut cut) const
+{
+    countOperations(line.size());
+
+    const auto text_end = findTextEnd(line, 0, line.size());
+
+    auto pos = std::size_t {0};
+    const auto findDelimiter = [&]() {
+        while (pos < text_end and kindOf(line[pos]) == 0) {
+            ++pos;
+        }
+    };
+
+    std::size_t part_begin = 0;
+    for (findDelimiter(); pos < text_end; ++pos, findDelimiter()) {
+        if (isSplitBefore(line, pos, text_end)) {
+            const auto part_end = findTextEnd(line, part_begin, pos);
+            if (part_end != part_begin) {
+                cut(part_end);
+                part_begin = part_end;
+            }
+        }
+
+        if (isSplitAfter(line, pos, text_end)) {
+            cut(pos + 1);
+            part_begin = pos + 1;
+        }
+    }
+}
+
+
+std::size_t
+Splitter::splitLine(FileContent &content, const FileContent::iterator line_it) const
+{
+    Line &line = *line_it;
+    const auto insert_it = std::next(line_it);
+    auto first_part_end = Line::npos;
+    std::size_t part_begin = 0;
+    std::size_t inserted_lines = 0;
+
+    forEachCut(line, [&](const std::size_t part_end) {
+        if (first_part_end == Line::npos) {
+            first_part_end = part_end;
+        }
+        else {
+            countOperations(part_end - part_begin);
+            content.emplace(insert_it, line.cbegin() + part_begin, line.cbegin() + part_end);
+            ++inserted_lines;
+        }
+        part_begin = part_end;
+    });
+
+    if (first_part_end == Line::npos) {
+        return 0;
+    }
+
+    countOperations(line.size() - part_begin);
+    content.emplace(insert_it, line.cbegin() + part_begin, line.cend());
+    line.resize(first_part_end);
+    return inserted_lines + 1;
+}
+
+
+void
+Splitter::findCuts(const std::string_view line, std::vector<std::size_t> &cuts) const
+{
+    forEachCut(line, [&cuts](const std::size_t cut) {
+        cuts.push_back(cut);
+    });
+}
+
+
+std::uint8_t
+Splitter::kindOf(const char character) const noexcept
+{
+    return kinds_[static_cast<unsigned char>(character)];
+}
+
+
+bool
+Splitter::isSplitAfter(const std::string_view line, const std::size_t pos, const std::size_t text_end) const noexcept
+{
+    return (kindOf(line[pos]) & split_after)
+           and pos + 1 < text_end
+           and not (keep_delimiter_runs_ and (kindOf(line[pos + 1]) & split_after));
+}
+
+
+bool
+Splitter::isSplitBefore(const std::string_view line, const std::size_t pos, const std::size_t text_end) const noexcept
+{
+    return (kindOf(line[pos]) & split_before)
+           and not (keep_trailing_delimiter_ and pos + 1 == text_end)
+           and not (keep_delimiter_runs_ and pos > 0 and (kindOf(line[pos - 1]) & split_before));
+}
+
+
+void
+splitLines(FileContent &content, const SplitOptions &options)
+{
+    const Splitter splitter(options);
+
+    for (auto line_it = content.begin(); line_it != content.end(); ++line_it) {
+        std::advance(line_it, splitter.splitLine(content, line_it));
+    }
+}
+
+}
@@ -7,40 +7,43 @@
  */
 
 #include <formatter/detail/UpdateIndentation.hpp>
+#include <formatter/detail/OperationCounter.hpp>
 
 #include <algorithm>
-#include <numeric>
 #include <string_view>
+#include <utility>
 #include <vector>
 
-using NumberOfIndentationChars = long;
-using IndentationParts = std::vector<NumberOfIndentationChars>;
+using NumberOfIndentationChars = formatter::detail::Indenter::NumberOfIndentationChars;
+using IndentationParts = formatter::detail::Indenter::IndentationParts;
 
 
 namespace
 {
 
+/*
+ * The sum of the parts is kept up to date, so the indentation level is
+ * known without walking all the parts.
+ */
 void
-lstrip(Line &line)
-{
-    line.erase(line.begin(),
-               std::find_if_not(line.begin(), line.end(), is_white_char));
-}
-
-
-void
-increase_indent(IndentationParts &indentation_parts, const NumberOfIndentationChars to_increase)
+increase_indent(IndentationParts &indentation_parts, NumberOfIndentationChars &indentation_sum,
+                const NumberOfIndentationChars to_increase)
 {
+    formatter::detail::countOperations(1);
     indentation_parts.push_back(to_increase);
+    indentation_sum += to_increase;
 }
 
 
 void
-decrease_indent(IndentationParts &indentation_parts, NumberOfIndentationChars to_reduce)
+decrease_indent(IndentationParts &indentation_parts, NumberOfIndentationChars &indentation_sum,
+                NumberOfIndentationChars to_reduce)
 {
     while (to_reduce > 0 and not indentation_parts.empty()) {
+        formatter::detail::countOperations(1);
         auto current = indentation_parts.back();
         indentation_parts.pop_back();
+        indentation_sum -= current;
 
         if (to_reduce > current) {
             to_reduce = to_reduce - current;
@@ -53,21 +56,97 @@ decrease_indent(IndentationParts &indentation_parts, NumberOfIndentationChars to
 
         if (current > 0) {
             indentation_parts.push_back(current);
+            indentation_sum += current;
+        }
+    }
+}
+
+
+struct LineTriggers
+{
+    NumberOfIndentationChars leading_decrease {0};
+    NumberOfIndentationChars balance {0};
+};
+
+
+bool
+is_decrease_char(const char c, const formatter::IndentationOptions &options)
+{
+    return options.decrease_indentation_chars.find(c) != options.decrease_indentation_chars.end();
+}
+
+
+/*
+ * The leading decrease triggers reduce the indentation of the line itself,
+ * the rest changes the indentation of the following lines.
+ */
+LineTriggers
+find_char_triggers(const Line &line, const std::size_t content_begin, const formatter::IndentationOptions &options)
+{
+    formatter::detail::countOperations(line.size() - content_begin);
+
+    LineTriggers triggers;
+    auto it = std::next(line.cbegin(), content_begin);
+
+    if (options.reduce_indent_for_last_decrease_char) {
+        const auto first_non_decrease_indentation_char = std::find_if_not(it, line.cend(), [&](char c){
+            return is_decrease_char(c, options);
+        });
+        triggers.leading_decrease = std::distance(it, first_non_decrease_indentation_char);
+        it = first_non_decrease_indentation_char;
+    }
+
+    for (; it != line.cend(); ++it) {
+        if (options.increase_indentation_chars.find(*it) != options.increase_indentation_chars.end()) {
+            ++triggers.balance;
+        }
+        if (is_decrease_char(*it, options)) {
+            --triggers.balance;
         }
     }
+
+    return triggers;
+}
+
+
+LineTriggers
+find_keyword_triggers(const Line &line, const std::size_t content_begin,
+                      const formatter::IndentationOptions &options,
+                      const formatter::detail::KeywordMatcher &keyword_matcher)
+{
+    formatter::detail::countOperations(line.size() - content_begin);
+
+    LineTriggers triggers;
+    bool is_leading = options.reduce_indent_for_last_decrease_char;
+    std::size_t leading_end = content_begin;
+
+    keyword_matcher.forEachMatch(line, content_begin, [&](const formatter::detail::KeywordMatcher::Match &match) {
+        if (is_leading and match.decreases and match.begin == leading_end) {
+            ++triggers.leading_decrease;
+            leading_end = match.end;
+            return;
+        }
+
+        is_leading = false;
+        triggers.balance += static_cast<NumberOfIndentationChars>(match.increases)
+                            - static_cast<NumberOfIndentationChars>(match.decreases);
+    });
+
+    return triggers;
 }
 
 
 unsigned
-indentation_level(const IndentationParts &indentation_parts, const formatter::IndentationOptions &options)
+indentation_level(const IndentationParts &indentation_parts, const NumberOfIndentationChars indentation_sum,
+                  const formatter::IndentationOptions &options)
 {
+    formatter::detail::countOperations(1);
+
     if (options.progressive_indent) {
         return indentation_parts.size();
     }
     else {
-        return std::accumulate(indentation_parts.begin(),
-                               indentation_parts.end(),
-                               0);
+        return indentation_sum;
     }
 }
 
@@ -76,56 +155,90 @@ indentation_level(const IndentationParts &indentation_parts, const formatter::In
 namespace formatter::detail
 {
 
-void
-updateIndentation(FileContent &content,
-                  const IndentationOptions &options)
+Indenter::Indenter(const IndentationOptions &options, std::pmr::memory_resource *resource)
+    : Indenter(options, nullptr, resource)
 {
-    IndentationParts indentation_parts;
+}
 
-    for (auto &line : content) {
-        lstrip(line);
-
-        const bool decrease_indent_before_line_content =
-            options.reduce_indent_for_last_decrease_char
-            and line.length() > 0
-            and options.decrease_indentation_chars.find(line.at(0)) != options.decrease_indentation_chars.end();
-
-        unsigned already_analyzed = 0;
-        if (decrease_indent_before_line_content) {
-            const auto first_non_decrease_indentation_char = std::find_if_not(line.cbegin(), line.cend(), [&](char c){
-                return options.decrease_indentation_chars.find(c) != options.decrease_indentation_chars.end();
-            });
-            const auto indentation_chars = std::distance(line.cbegin(), first_non_decrease_indentation_char);
-            already_analyzed = indentation_chars;
-
-            decrease_indent(indentation_parts, indentation_chars);
-        }
 
-        if (line.length() > 0) {
-            constexpr char indentation_char = ' ';
+Indenter::Indenter(const IndentationOptions &options,
+                   KeywordMatcherPtr keyword_matcher,
+                   std::pmr::memory_resource *resource)
+    : options_(&options),
+      keyword_matcher_(keyword_matcher ? std::move(keyword_matcher) : KeywordMatcher::compile(options)),
+      indentation_parts_(resource)
+{
+}
 
-            const auto num_of_chars_to_insert =
-                indentation_level(indentation_parts, options) * options.num_of_spaces;
-            line.insert(0, num_of_chars_to_insert, indentation_char);
-            already_analyzed += num_of_chars_to_insert;
-        }
 
-        NumberOfIndentationChars indentation_chars = 0;
-        for (auto it = std::next(line.cbegin(), already_analyzed); it != line.cend(); ++it) {
-            if (options.increase_indentation_chars.find(*it) != options.increase_indentation_chars.end()) {
-                ++indentation_chars;
-            }
-            if (options.decrease_indentation_chars.find(*it) != options.decrease_indentation_chars.end()) {
-                --indentation_chars;
-            }
-        }
+bool
+Indenter::updateLine(Line &line)
+{
+    constexpr char indentation_char = ' ';
 
-        if (indentation_chars > 0) {
-            increase_indent(indentation_parts, indentation_chars);
-        }
-        else if (indentation_chars < 0) {
-            decrease_indent(indentation_parts, abs(indentation_chars));
-        }
+    const auto content_begin = std::find_if_not(line.cbegin(), line.cend(), is_white_char);
+    const auto leading_chars = static_cast<std::size_t>(std::distance(line.cbegin(), content_begin));
+    countOperations(leading_chars);
+
+    const auto triggers = keyword_matcher_ ? find_keyword_triggers(line, leading_chars, *options_, *keyword_matcher_)
+                                           : find_char_triggers(line, leading_chars, *options_);
+
+    decrease_indent(indentation_parts_, indentation_sum_, triggers.leading_decrease);
+
+    std::size_t num_of_chars_to_insert = 0;
+    if (content_begin != line.cend()) {
+        num_of_chars_to_insert = indentation_level(indentation_parts_, indentation_sum_, *options_) * options_->num_of_spaces;
+    }
+
+    const bool is_already_indented =
+        leading_chars == num_of_chars_to_insert
+        and std::all_of(line.cbegin(), content_begin, [](char c){ return c == indentation_char; });
+
+    if (not is_already_indented) {
+        countOperations(num_of_chars_to_insert);
+        line.replace(0, leading_chars, num_of_chars_to_insert, indentation_char);
+    }
+
+    if (triggers.balance > 0) {
+        increase_indent(indentation_parts_, indentation_sum_, triggers.balance);
+    }
+    else if (triggers.balance < 0) {
+        decrease_indent(indentation_parts_, indentation_sum_, -triggers.balance);
+    }
+
+    return is_already_indented;
+}
+
+
+std::size_t
+Indenter::indentationLevel() const
+{
+    return indentation_level(indentation_parts_, indentation_sum_, *options_);
+}
+
+
+bool
+Indenter::operator==(const Indenter &other) const
+{
+    return indentation_parts_ == other.indentation_parts_;
+}
+
+
+bool
+Indenter::operator!=(const Indenter &other) const
+{
+    return not (*this == other);
+}
+
+
+void
+updateIndentation(FileContent &content,
+                  const IndentationOptions &options)
+{
+    Indenter indenter(options, content.get_allocator().resource());
+
+    for (auto &line : content) {
+        indenter.updateLine(line);
     }
 }
 
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <git/ChangedLines.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <sys/wait.h>
+
+
+namespace git
+{
+
+namespace
+{
+
+constexpr std::string_view new_file_marker = "+++ ";
+constexpr std::string_view hunk_marker = "@@ ";
+constexpr std::string_view new_file_prefix = "b/";
+constexpr std::string_view dev_null = "/dev/null";
+
+
+std::string
+quoteForShell(const std::string &argument)
+{
+    std::string quoted = "'";
+    for (const char c : argument) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        }
+        else {
+            quoted += c;
+        }
+    }
+    quoted += "'";
+
+    return quoted;
+}
+
+
+std::string
+runCommand(const std::string &command)
+{
+    std::unique_ptr<FILE, int(*)(FILE*)> pipe(popen(command.c_str(), "r"), pclose);
+    if (not pipe) {
+        throw GitError("unable to run: " + command);
+    }
+
+    std::string output;
+    std::array<char, 4096> buffer;
+    std::size_t read_bytes;
+    while ((read_bytes = fread(buffer.data(), 1, buffer.size(), pipe.get())) > 0) {
+        output.append(buffer.data(), read_bytes);
+    }
+
+    const int status = pclose(pipe.release());
+    if (status == -1 or not WIFEXITED(status) or WEXITSTATUS(status) != 0) {
+        throw GitError("command failed: " + command);
+    }
+
+    return output;
+}
+
+
+std::string
+gitCommand(const std::string &directory, const std::string &arguments)
+{
+    return "git -C " + quoteForShell(directory) + " " + arguments + " 2>/dev/null";
+}
+
+
+/*
+ * Decodes a path quoted by git the C way, e.g. "b/a\tb\303\251.c", the
+ * backslash escapes and the octal bytes of non-ASCII chars.
+ */
+std::string
+unquoteCPath(std::string_view path)
+{
+    std::string result;
+    while (not path.empty()) {
+        const char c = path.front();
+        path.remove_prefix(1);
+        if (c != '\\' or path.empty()) {
+            result += c;
+            continue;
+        }
+
+        const char escaped = path.front();
+        path.remove_prefix(1);
+        switch (escaped) {
+        case 'a':
+            result += '\a';
+            break;
+        case 'b':
+            result += '\b';
+            break;
+        case 'f':
+            result += '\f';
+            break;
+        case 'n':
+            result += '\n';
+            break;
+        case 'r':
+            result += '\r';
+            break;
+        case 't':
+            result += '\t';
+            break;
+        case 'v':
+            result += '\v';
+            break;
+        default:
+            if (escaped >= '0' and escaped <= '7') {
+                int code = escaped - '0';
+                for (int i = 0; i < 2 and not path.empty() and path.front() >= '0' and path.front() <= '7'; ++i) {
+                    code = code * 8 + (path.front() - '0');
+                    path.remove_prefix(1);
+                }
+                result += static_cast<char>(code);
+            }
+            else {
+                result += escaped;
+            }
+        }
+    }
+
+    return result;
+}
+
+
+std::string
+unquotePath(std::string_view path)
+{
+    std::string unquoted;
+    if (path.size() >= 2 and path.front() == '"' and path.back() == '"') {
+        unquoted = unquoteCPath(path.substr(1, path.size() - 2));
+    }
+    else {
+        unquoted = std::string(path);
+    }
+
+    if (std::string_view(unquoted).substr(0, new_file_prefix.size()) == new_file_prefix) {
+        unquoted.erase(0, new_file_prefix.size());
+    }
+
+    return unquoted;
+}
+
+
+std::size_t
+parseNumber(std::string_view &text)
+{
+    std::size_t number = 0;
+    while (not text.empty() and text.front() >= '0' and text.front() <= '9') {
+        number = number * 10 + (text.front() - '0');
+        text.remove_prefix(1);
+    }
+
+    return number;
+}
+
+
+/*
+ * Parses the new file part of a hunk header: "@@ -a,b +c,d @@".
+ */
+bool
+parseHunkHeader(std::string_view header, LineRange &range)
+{
+    const auto new_part_pos = header.find(" +");
+    if (new_part_pos == std::string_view::npos) {
+        return false;
+    }
+    header.remove_prefix(new_part_pos + 2);
+
+    const auto first = parseNumber(header);
+    std::size_t count = 1;
+    if (not header.empty() and header.front() == ',') {
+        header.remove_prefix(1);
+        count = parseNumber(header);
+    }
+
+    if (count == 0) {
+        return false;
+    }
+
+    range.first = first;
+    range.last = first + count - 1;
+    return true;
+}
+
+}
+
+
+ChangedLines
+parseUnifiedDiff(std::string_view diff)
+{
+    ChangedLines changed_lines;
+    std::vector<LineRange> *current_file_ranges = nullptr;
+
+    while (not diff.empty()) {
+        auto line_end = diff.find('\n');
+        if (line_end == std::string_view::npos) {
+            line_end = diff.size();
+        }
+        const auto line = diff.substr(0, line_end);
+        diff.remove_prefix(std::min(line_end + 1, diff.size()));
+
+        if (line.substr(0, new_file_marker.size()) == new_file_marker) {
+            const auto path = line.substr(new_file_marker.size());
+            if (path == dev_null) {
+                current_file_ranges = nullptr;
+            }
+            else {
+                current_file_ranges = &changed_lines[unquotePath(path)];
+            }
+        }
+        else if (current_file_ranges
+                 and line.substr(0, hunk_marker.size()) == hunk_marker) {
+            LineRange range;
+            if (parseHunkHeader(line, range)) {
+                current_file_ranges->push_back(range);
+            }
+        }
+    }
+
+    for (auto it = changed_lines.begin(); it != changed_lines.end();) {
+        if (it->second.empty()) {
+            it = changed_lines.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    return changed_lines;
+}
+
+
+std::string
+repositoryRoot(const std::string &directory)
+{
+    auto root = runCommand(gitCommand(directory, "rev-parse --show-toplevel"));
+    while (not root.empty() and root.back() == '\n') {
+        root.pop_back();
+    }
+
+    return root;
+}
+
+
+ChangedLines
+changedLines(const std::string &directory, const std::string &base_revision)
+{
+    const auto diff = runCommand(gitCommand(directory,
+        "-c core.quotePath=false diff --no-color --no-ext-diff --no-renames --unified=0"
+        " --src-prefix=a/ --dst-prefix=b/ "
+        + quoteForShell(base_revision) + " --"));
+
+    return parseUnifiedDiff(diff);
+}
+
+}
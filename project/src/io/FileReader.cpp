@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <io/FileReader.hpp>
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace io
+{
+
+namespace
+{
+
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(const int fd)
+        : fd_(fd)
+    {
+    }
+
+    ~FileDescriptor()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor& operator=(const FileDescriptor &) = delete;
+
+    int get() const noexcept
+    {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+
+[[noreturn]] void
+throwSystemError(const char *name)
+{
+    throw std::system_error(errno, std::generic_category(), name);
+}
+
+}
+
+
+std::pmr::string
+readRawFile(const char *name, std::pmr::memory_resource *resource)
+{
+    const FileDescriptor fd(open(name, O_RDONLY | O_CLOEXEC));
+    if (fd.get() < 0) {
+        throwSystemError(name);
+    }
+
+    struct stat file_status;
+    if (fstat(fd.get(), &file_status) != 0) {
+        throwSystemError(name);
+    }
+
+    std::pmr::string data(resource);
+    data.resize(static_cast<std::size_t>(file_status.st_size));
+
+    std::size_t read_bytes = 0;
+    while (read_bytes < data.size()) {
+        const auto result = read(fd.get(), data.data() + read_bytes, data.size() - read_bytes);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwSystemError(name);
+        }
+        if (result == 0) {
+            break;
+        }
+        read_bytes += static_cast<std::size_t>(result);
+    }
+    data.resize(read_bytes);
+
+    /*
+     * The size reported by fstat is only a hint for special and growing files.
+     */
+    char tail[4096];
+    while (true) {
+        const auto result = read(fd.get(), tail, sizeof(tail));
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwSystemError(name);
+        }
+        if (result == 0) {
+            break;
+        }
+        data.append(tail, static_cast<std::size_t>(result));
+    }
+
+    return data;
+}
+
+
+LineBlockReader::LineBlockReader(const char *name)
+    : name_(name),
+      fd_(open(name, O_RDONLY | O_CLOEXEC))
+{
+    if (fd_ < 0) {
+        throwSystemError(name);
+    }
+}
+
+
+LineBlockReader::~LineBlockReader()
+{
+    close(fd_);
+}
+
+
+std::size_t
+LineBlockReader::readBlock(std::pmr::string &block, const std::size_t block_size)
+{
+    block.assign(carry_);
+    carry_.clear();
+
+    const auto offset = offset_;
+    std::size_t searched_bytes = 0;
+
+    while (not is_eof_) {
+        while (block.size() < searched_bytes + block_size and not is_eof_) {
+            readSome(block, searched_bytes + block_size - block.size());
+        }
+        if (is_eof_) {
+            break;
+        }
+
+        /*
+         * A CR at the end may be followed by LF in the next read.
+         */
+        for (auto pos = block.size() - 1; pos + 1 > searched_bytes; --pos) {
+            if (block[pos] == '\n' or (block[pos] == '\r' and pos + 1 < block.size())) {
+                carry_.assign(block, pos + 1);
+                block.resize(pos + 1);
+                offset_ += block.size();
+                return offset;
+            }
+        }
+        searched_bytes = block.size() - 1;
+    }
+
+    offset_ += block.size();
+    return offset;
+}
+
+
+void
+LineBlockReader::readSome(std::pmr::string &block, const std::size_t size)
+{
+    const auto old_size = block.size();
+    block.resize(old_size + size);
+
+    while (true) {
+        const auto result = read(fd_, block.data() + old_size, size);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            block.resize(old_size);
+            throwSystemError(name_.c_str());
+        }
+
+        block.resize(old_size + static_cast<std::size_t>(result));
+        is_eof_ = result == 0;
+        return;
+    }
+}
+
+
+FileContent
+splitLines(const std::string_view normalized_text, std::pmr::memory_resource *resource)
+{
+    FileContent content(resource);
+
+    std::size_t line_begin = 0;
+    while (line_begin < normalized_text.size()) {
+        auto line_end = normalized_text.find('\n', line_begin);
+        if (line_end == std::string_view::npos) {
+            line_end = normalized_text.size();
+        }
+
+        content.emplace_back(normalized_text.substr(line_begin, line_end - line_begin));
+        line_begin = line_end + 1;
+    }
+
+    return content;
+}
+
+
+FileContent
+readFile(const char *name, TextFormat &format, std::pmr::memory_resource *resource)
+{
+    const auto normalized = normalizeInput(readRawFile(name, resource), resource);
+    format = normalized.format;
+
+    return splitLines(normalized.text, resource);
+}
+
+}
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <io/FileWriter.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+namespace io
+{
+
+namespace
+{
+
+constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+
+
+void
+moveIntoPlace(const std::string &temporary_name, const std::string &name)
+{
+    std::error_code error;
+    const auto original_status = std::filesystem::status(name, error);
+    if (not error) {
+        std::filesystem::permissions(temporary_name, original_status.permissions(), error);
+    }
+
+    if (std::rename(temporary_name.c_str(), name.c_str()) != 0) {
+        const auto rename_error = errno;
+        std::remove(temporary_name.c_str());
+        throw std::filesystem::filesystem_error("unable to replace file", name,
+                                                std::error_code(rename_error, std::generic_category()));
+    }
+}
+
+
+[[noreturn]] void
+throwSystemError(const std::string &name)
+{
+    throw std::system_error(errno, std::generic_category(), name);
+}
+
+
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(const int fd)
+        : fd_(fd)
+    {
+    }
+
+    ~FileDescriptor()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor& operator=(const FileDescriptor &) = delete;
+
+    int get() const noexcept
+    {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+
+class MappedMemory
+{
+public:
+    MappedMemory(const int fd, const std::size_t size, const std::string &name)
+        : size_(size)
+    {
+        data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data_ == MAP_FAILED) {
+            throwSystemError(name);
+        }
+    }
+
+    ~MappedMemory()
+    {
+        munmap(data_, size_);
+    }
+
+    MappedMemory(const MappedMemory &) = delete;
+    MappedMemory& operator=(const MappedMemory &) = delete;
+
+    char* data() const noexcept
+    {
+        return static_cast<char*>(data_);
+    }
+
+private:
+    void *data_;
+    std::size_t size_;
+};
+
+
+/*
+ * Reserves the blocks up front, so running out of space is reported here
+ * instead of as SIGBUS while writing to the mapping.
+ */
+void
+resizeFile(const int fd, const std::size_t size, const std::string &name)
+{
+    const auto length = static_cast<off_t>(size);
+    const int result = posix_fallocate(fd, 0, length);
+    if (result == EOPNOTSUPP or result == EINVAL) {
+        if (ftruncate(fd, length) != 0) {
+            throwSystemError(name);
+        }
+    }
+    else if (result != 0) {
+        throw std::system_error(result, std::generic_category(), name);
+    }
+}
+
+
+/*
+ * Consecutive lines copied by one thread, starting at the offset.
+ */
+struct OutputRange
+{
+    FileContent::const_iterator begin;
+    FileContent::const_iterator end;
+    std::size_t offset;
+};
+
+
+std::vector<OutputRange>
+splitIntoRanges(const FileContent &content, const std::size_t first_offset,
+                const std::size_t line_ending_size, const std::size_t bytes_per_range)
+{
+    std::vector<OutputRange> ranges;
+    ranges.push_back(OutputRange{content.cbegin(), content.cend(), first_offset});
+
+    std::size_t offset = first_offset;
+    for (auto line_it = content.cbegin(); line_it != content.cend(); ++line_it) {
+        if (offset - ranges.back().offset >= bytes_per_range) {
+            ranges.back().end = line_it;
+            ranges.push_back(OutputRange{line_it, content.cend(), offset});
+        }
+        offset += line_it->size() + line_ending_size;
+    }
+
+    return ranges;
+}
+
+
+void
+copyRange(char *output, const OutputRange &range, const FileContent::const_iterator last_line_it,
+          const std::string_view line_ending, const bool ends_with_newline)
+{
+    auto *position = output + range.offset;
+    for (auto line_it = range.begin; line_it != range.end; ++line_it) {
+        std::memcpy(position, line_it->data(), line_it->size());
+        position += line_it->size();
+
+        if (line_it != last_line_it or ends_with_newline) {
+            std::memcpy(position, line_ending.data(), line_ending.size());
+            position += line_ending.size();
+        }
+    }
+}
+
+
+std::size_t
+contentSize(const FileContent &content, const TextFormat &format)
+{
+    const auto line_ending = lineEndingChars(format.line_ending);
+
+    std::size_t size = format.has_bom ? utf8_bom.size() : 0;
+    for (const auto &line : content) {
+        size += line.size() + line_ending.size();
+    }
+    if (not content.empty() and not format.ends_with_newline) {
+        size -= line_ending.size();
+    }
+
+    return size;
+}
+
+}
+
+
+void
+writeFile(const std::string &name, const std::function<void(std::ostream &)> &write)
+{
+    const auto temporary_name = name + std::string(temporary_file_suffix);
+
+    try {
+        auto f = std::ofstream(temporary_name, std::ios::binary | std::ios::trunc);
+        f.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+        write(f);
+        /*
+         * The last flush happens on close, it fails e.g. on a full disk and
+         * the destructor would drop the error.
+         */
+        f.close();
+    }
+    catch (...) {
+        std::remove(temporary_name.c_str());
+        throw;
+    }
+
+    moveIntoPlace(temporary_name, name);
+}
+
+
+std::string_view
+lineEndingChars(const LineEnding line_ending)
+{
+    switch (line_ending) {
+    case LineEnding::CRLF:
+        return "\r\n";
+    case LineEnding::CR:
+        return "\r";
+    case LineEnding::LF:
+        break;
+    }
+
+    return "\n";
+}
+
+
+void
+writeContent(std::ostream &output, const FileContent &content, const TextFormat &format)
+{
+    const auto line_ending = lineEndingChars(format.line_ending);
+
+    if (format.has_bom) {
+        output << utf8_bom;
+    }
+
+    for (auto line_it = content.cbegin(); line_it != content.cend(); ++line_it) {
+        output << *line_it;
+
+        const bool is_last_line = std::next(line_it) == content.cend();
+        if (not is_last_line or format.ends_with_newline) {
+            output << line_ending;
+        }
+    }
+}
+
+
+void
+writeContent(std::string &output, const FileContent &content, const TextFormat &format)
+{
+    const auto line_ending = lineEndingChars(format.line_ending);
+    output.reserve(output.size() + contentSize(content, format));
+
+    if (format.has_bom) {
+        output += utf8_bom;
+    }
+
+    for (auto line_it = content.cbegin(); line_it != content.cend(); ++line_it) {
+        output += *line_it;
+
+        const bool is_last_line = std::next(line_it) == content.cend();
+        if (not is_last_line or format.ends_with_newline) {
+            output += line_ending;
+        }
+    }
+}
+
+
+void
+writeFile(const std::string &name, const FileContent &content, const TextFormat &format)
+{
+    writeFile(name, [&](std::ostream &output) {
+        writeContent(output, content, format);
+    });
+}
+
+
+void
+writeFile(const std::string &name, const std::string_view data)
+{
+    writeFile(name, [&](std::ostream &output) {
+        output.write(data.data(), static_cast<std::streamsize>(data.size()));
+    });
+}
+
+
+namespace
+{
+
+/*
+ * The first range is copied by the calling thread, the others by their
+ * own threads.
+ */
+void
+copyContent(char *output, const FileContent &content, const TextFormat &format, const std::size_t size,
+            const MappedWriteOptions &options)
+{
+    if (content.empty()) {
+        return;
+    }
+
+    const auto line_ending = lineEndingChars(format.line_ending);
+    const std::size_t bom_size = format.has_bom ? utf8_bom.size() : 0;
+    const auto threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const auto bytes_per_range = std::max(options.min_bytes_per_thread, size / threads + 1);
+    const auto ranges = splitIntoRanges(content, bom_size, line_ending.size(), bytes_per_range);
+    const auto last_line_it = std::prev(content.cend());
+
+    std::vector<std::thread> workers;
+    const auto join_workers = [&workers] {
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    };
+
+    try {
+        for (std::size_t i = 1; i < ranges.size(); ++i) {
+            workers.emplace_back(copyRange, output, std::cref(ranges[i]), last_line_it,
+                                 line_ending, format.ends_with_newline);
+        }
+    }
+    catch (...) {
+        join_workers();
+        throw;
+    }
+
+    copyRange(output, ranges.front(), last_line_it, line_ending, format.ends_with_newline);
+    join_workers();
+}
+
+}
+
+
+void
+writeFileMapped(const std::string &name, const FileContent &content, const TextFormat &format,
+                const MappedWriteOptions &options)
+{
+    const std::size_t bom_size = format.has_bom ? utf8_bom.size() : 0;
+    const auto size = contentSize(content, format);
+
+    const auto temporary_name = name + std::string(temporary_file_suffix);
+
+    try {
+        const FileDescriptor fd(open(temporary_name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+        if (fd.get() < 0) {
+            throwSystemError(temporary_name);
+        }
+
+        if (size > 0) {
+            resizeFile(fd.get(), size, temporary_name);
+            const MappedMemory output(fd.get(), size, temporary_name);
+
+            std::memcpy(output.data(), utf8_bom.data(), bom_size);
+            copyContent(output.data(), content, format, size, options);
+        }
+    }
+    catch (...) {
+        std::remove(temporary_name.c_str());
+        throw;
+    }
+
+    moveIntoPlace(temporary_name, name);
+}
+
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <io/InputNormalizer.hpp>
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace io
+{
+
+namespace
+{
+
+constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+
+
+bool
+isSpecialByte(const unsigned char c)
+{
+    return c >= 0x80
+        or c == '\r';
+}
+
+
+/*
+ * Returns the position of the first byte, starting from pos, which is not
+ * plain ASCII or is a carriage return. Everything before it can be copied
+ * to the output as is.
+ */
+std::size_t
+findSpecialByte(const char *data, std::size_t pos, const std::size_t size)
+{
+#if defined(__SSE2__)
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+    while (pos + sizeof(__m128i) <= size) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        const int mask = _mm_movemask_epi8(chunk)
+                       | _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, carriage_return));
+        if (mask != 0) {
+            return pos + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+        pos += sizeof(__m128i);
+    }
+#endif
+
+    while (pos < size and not isSpecialByte(static_cast<unsigned char>(data[pos]))) {
+        ++pos;
+    }
+    return pos;
+}
+
+
+bool
+isContinuationByte(const unsigned char c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+
+/*
+ * Returns the length of the valid UTF-8 sequence starting at data,
+ * or 0 when the sequence is invalid (overlong, surrogate, out of range
+ * or truncated).
+ */
+std::size_t
+utf8SequenceLength(const unsigned char *data, const std::size_t available)
+{
+    const unsigned char lead = data[0];
+
+    std::size_t length = 0;
+    unsigned char second_min = 0x80;
+    unsigned char second_max = 0xBF;
+
+    if (lead >= 0xC2 and lead <= 0xDF) {
+        length = 2;
+    }
+    else if (lead >= 0xE0 and lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) {
+            second_min = 0xA0;
+        }
+        else if (lead == 0xED) {
+            second_max = 0x9F;
+        }
+    }
+    else if (lead >= 0xF0 and lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) {
+            second_min = 0x90;
+        }
+        else if (lead == 0xF4) {
+            second_max = 0x8F;
+        }
+    }
+    else {
+        return 0;
+    }
+
+    if (available < length
+        or data[1] < second_min
+        or data[1] > second_max) {
+        return 0;
+    }
+
+    for (std::size_t i = 2; i < length; ++i) {
+        if (not isContinuationByte(data[i])) {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+}
+
+
+InvalidInputError::InvalidInputError(const std::size_t offset)
+    : std::runtime_error("invalid UTF-8 sequence at byte offset " + std::to_string(offset)),
+      offset_(offset)
+{
+}
+
+
+std::size_t
+InvalidInputError::offset() const noexcept
+{
+    return offset_;
+}
+
+
+namespace
+{
+
+NormalizedInput
+normalize(const std::string_view data, const bool detect_bom, const std::size_t offset,
+          std::pmr::memory_resource *resource)
+{
+    NormalizedInput result {std::pmr::string(resource), TextFormat{}};
+
+    std::size_t pos = 0;
+    if (detect_bom and data.substr(0, utf8_bom.size()) == utf8_bom) {
+        result.format.has_bom = true;
+        pos = utf8_bom.size();
+    }
+
+    /*
+     * An empty view may have no data, memchr must not get a null pointer.
+     */
+    const auto *first_lf = pos < data.size()
+                           ? static_cast<const char*>(std::memchr(data.data() + pos, '\n', data.size() - pos))
+                           : nullptr;
+    const auto first_lf_pos = first_lf ? static_cast<std::size_t>(first_lf - data.data()) : data.size();
+    bool line_ending_detected = false;
+
+    result.text.reserve(data.size() - pos);
+
+    while (pos < data.size()) {
+        const auto special_pos = findSpecialByte(data.data(), pos, data.size());
+        result.text.append(data.data() + pos, special_pos - pos);
+        pos = special_pos;
+
+        if (pos == data.size()) {
+            break;
+        }
+
+        if (data[pos] == '\r') {
+            const bool is_crlf = pos + 1 < data.size() and data[pos + 1] == '\n';
+
+            if (not line_ending_detected and pos < first_lf_pos) {
+                result.format.line_ending = is_crlf ? LineEnding::CRLF : LineEnding::CR;
+            }
+            line_ending_detected = true;
+
+            result.text.push_back('\n');
+            pos += is_crlf ? 2 : 1;
+        }
+        else {
+            const auto length = utf8SequenceLength(reinterpret_cast<const unsigned char*>(data.data() + pos),
+                                                   data.size() - pos);
+            if (length == 0) {
+                throw InvalidInputError(offset + pos);
+            }
+
+            result.text.append(data.data() + pos, length);
+            pos += length;
+        }
+    }
+
+    result.format.ends_with_newline = not result.text.empty()
+                                      and result.text.back() == '\n';
+
+    return result;
+}
+
+}
+
+
+NormalizedInput
+normalizeInput(const std::string_view data, std::pmr::memory_resource *resource)
+{
+    return normalize(data, true, 0, resource);
+}
+
+
+NormalizedInput
+normalizeInputBlock(const std::string_view data, const std::size_t offset, std::pmr::memory_resource *resource)
+{
+    return normalize(data, false, offset, resource);
+}
+
+}
@@ -0,0 +1,627 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <json/Json.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+
+namespace json
+{
+
+namespace
+{
+
+constexpr std::size_t max_depth = 256;
+
+
+class Parser
+{
+public:
+    explicit Parser(const std::string_view text)
+        : text_(text)
+    {
+    }
+
+    Value parseDocument()
+    {
+        auto value = parseValue(0);
+        skipWhiteSpace();
+        if (pos_ != text_.size()) {
+            fail("unexpected data after the value");
+        }
+
+        return value;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string &message) const
+    {
+        throw ParseError(pos_, message);
+    }
+
+    void skipWhiteSpace()
+    {
+        while (pos_ < text_.size()
+               and (text_[pos_] == ' ' or text_[pos_] == '\t' or text_[pos_] == '\n' or text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(const char c)
+    {
+        skipWhiteSpace();
+        if (pos_ < text_.size() and text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+
+        return false;
+    }
+
+    void expect(const char c)
+    {
+        if (not consume(c)) {
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+
+    void expectWord(const std::string_view word)
+    {
+        if (text_.substr(pos_, word.size()) != word) {
+            fail("invalid literal");
+        }
+        pos_ += word.size();
+    }
+
+    Value parseValue(const std::size_t depth)
+    {
+        if (depth > max_depth) {
+            fail("too deeply nested");
+        }
+
+        skipWhiteSpace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of data");
+        }
+
+        switch (text_[pos_]) {
+        case '{':
+            return parseObject(depth);
+        case '[':
+            return parseArray(depth);
+        case '"':
+            return parseString();
+        case 't':
+            expectWord("true");
+            return true;
+        case 'f':
+            expectWord("false");
+            return false;
+        case 'n':
+            expectWord("null");
+            return nullptr;
+        default:
+            return parseNumber();
+        }
+    }
+
+    Value parseObject(const std::size_t depth)
+    {
+        ++pos_;
+        Object object;
+        if (consume('}')) {
+            return object;
+        }
+
+        do {
+            skipWhiteSpace();
+            if (pos_ >= text_.size() or text_[pos_] != '"') {
+                fail("expected a member name");
+            }
+            auto key = parseString();
+            expect(':');
+            auto value = parseValue(depth + 1);
+            object.emplace_back(std::move(key), std::move(value));
+        } while (consume(','));
+
+        expect('}');
+        return object;
+    }
+
+    Value parseArray(const std::size_t depth)
+    {
+        ++pos_;
+        Array array;
+        if (consume(']')) {
+            return array;
+        }
+
+        do {
+            array.push_back(parseValue(depth + 1));
+        } while (consume(','));
+
+        expect(']');
+        return array;
+    }
+
+    unsigned parseHex4()
+    {
+        if (pos_ + 4 > text_.size()) {
+            fail("invalid escape");
+        }
+
+        unsigned code = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = text_[pos_++];
+            code <<= 4;
+            if (c >= '0' and c <= '9') {
+                code |= static_cast<unsigned>(c - '0');
+            }
+            else if (c >= 'a' and c <= 'f') {
+                code |= static_cast<unsigned>(c - 'a' + 10);
+            }
+            else if (c >= 'A' and c <= 'F') {
+                code |= static_cast<unsigned>(c - 'A' + 10);
+            }
+            else {
+                fail("invalid escape");
+            }
+        }
+
+        return code;
+    }
+
+    static void appendUtf8(std::string &output, const unsigned code)
+    {
+        if (code < 0x80) {
+            output += static_cast<char>(code);
+        }
+        else if (code < 0x800) {
+            output += static_cast<char>(0xC0 | (code >> 6));
+            output += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000) {
+            output += static_cast<char>(0xE0 | (code >> 12));
+            output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else {
+            output += static_cast<char>(0xF0 | (code >> 18));
+            output += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            output += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            output += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    /*
+     * Runs without escapes are appended at once, documents sent by
+     * editors are mostly such runs.
+     */
+    std::string parseString()
+    {
+        ++pos_;
+        std::string result;
+
+        while (true) {
+            const auto run_end = text_.find_first_of("\"\\", pos_);
+            if (run_end == std::string_view::npos) {
+                fail("unterminated string");
+            }
+            result.append(text_.substr(pos_, run_end - pos_));
+            pos_ = run_end + 1;
+
+            if (text_[run_end] == '"') {
+                return result;
+            }
+            if (pos_ >= text_.size()) {
+                fail("unterminated string");
+            }
+
+            const char escaped = text_[pos_++];
+            switch (escaped) {
+            case '"':
+            case '\\':
+            case '/':
+                result += escaped;
+                break;
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'n':
+                result += '\n';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'u': {
+                auto code = parseHex4();
+                if (code >= 0xD800 and code < 0xDC00
+                    and text_.substr(pos_, 2) == "\\u") {
+                    pos_ += 2;
+                    const auto low = parseHex4();
+                    if (low < 0xDC00 or low >= 0xE000) {
+                        fail("invalid surrogate pair");
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(result, code);
+                break;
+            }
+            default:
+                fail("invalid escape");
+            }
+        }
+    }
+
+    Value parseNumber()
+    {
+        const auto begin = pos_;
+        if (pos_ < text_.size() and text_[pos_] == '-') {
+            ++pos_;
+        }
+        while (pos_ < text_.size()
+               and ((text_[pos_] >= '0' and text_[pos_] <= '9')
+                    or text_[pos_] == '.' or text_[pos_] == 'e' or text_[pos_] == 'E'
+                    or text_[pos_] == '+' or text_[pos_] == '-')) {
+            ++pos_;
+        }
+
+        const std::string number(text_.substr(begin, pos_ - begin));
+        char *end = nullptr;
+        const double value = std::strtod(number.c_str(), &end);
+        if (number.empty() or end != number.c_str() + number.size()) {
+            pos_ = begin;
+            fail("invalid value");
+        }
+
+        return value;
+    }
+
+    const std::string_view text_;
+    std::size_t pos_ {0};
+};
+
+
+const Value null_value;
+
+}
+
+
+Value::Value(std::nullptr_t)
+{
+}
+
+
+Value::Value(const bool value)
+    : value_(value)
+{
+}
+
+
+Value::Value(const int value)
+    : value_(static_cast<double>(value))
+{
+}
+
+
+Value::Value(const std::int64_t value)
+    : value_(static_cast<double>(value))
+{
+}
+
+
+Value::Value(const std::size_t value)
+    : value_(static_cast<double>(value))
+{
+}
+
+
+Value::Value(const double value)
+    : value_(value)
+{
+}
+
+
+Value::Value(const char *value)
+    : value_(std::string(value))
+{
+}
+
+
+Value::Value(std::string value)
+    : value_(std::move(value))
+{
+}
+
+
+Value::Value(Array value)
+    : value_(std::move(value))
+{
+}
+
+
+Value::Value(Object value)
+    : value_(std::move(value))
+{
+}
+
+
+bool
+Value::isNull() const noexcept
+{
+    return std::holds_alternative<std::nullptr_t>(value_);
+}
+
+
+bool
+Value::isBool() const noexcept
+{
+    return std::holds_alternative<bool>(value_);
+}
+
+
+bool
+Value::isNumber() const noexcept
+{
+    return std::holds_alternative<double>(value_);
+}
+
+
+bool
+Value::isString() const noexcept
+{
+    return std::holds_alternative<std::string>(value_);
+}
+
+
+bool
+Value::isArray() const noexcept
+{
+    return std::holds_alternative<Array>(value_);
+}
+
+
+bool
+Value::isObject() const noexcept
+{
+    return std::holds_alternative<Object>(value_);
+}
+
+
+bool
+Value::asBool() const
+{
+    if (not isBool()) {
+        throw TypeError("expected a boolean");
+    }
+    return std::get<bool>(value_);
+}
+
+
+double
+Value::asNumber() const
+{
+    if (not isNumber()) {
+        throw TypeError("expected a number");
+    }
+    return std::get<double>(value_);
+}
+
+
+std::int64_t
+Value::asInteger() const
+{
+    const auto number = asNumber();
+    if (std::trunc(number) != number or std::abs(number) > 9007199254740992.0) {
+        throw TypeError("expected an integer");
+    }
+    return static_cast<std::int64_t>(number);
+}
+
+
+const std::string&
+Value::asString() const
+{
+    if (not isString()) {
+        throw TypeError("expected a string");
+    }
+    return std::get<std::string>(value_);
+}
+
+
+const Array&
+Value::asArray() const
+{
+    if (not isArray()) {
+        throw TypeError("expected an array");
+    }
+    return std::get<Array>(value_);
+}
+
+
+const Object&
+Value::asObject() const
+{
+    if (not isObject()) {
+        throw TypeError("expected an object");
+    }
+    return std::get<Object>(value_);
+}
+
+
+const Value*
+Value::find(const std::string_view key) const
+{
+    if (not isObject()) {
+        return nullptr;
+    }
+
+    for (const auto &[member_key, member_value] : std::get<Object>(value_)) {
+        if (member_key == key) {
+            return &member_value;
+        }
+    }
+
+    return nullptr;
+}
+
+
+const Value&
+Value::operator[](const std::string_view key) const
+{
+    const auto *value = find(key);
+    return value ? *value : null_value;
+}
+
+
+bool
+Value::operator==(const Value &other) const
+{
+    return value_ == other.value_;
+}
+
+
+bool
+Value::operator!=(const Value &other) const
+{
+    return not (*this == other);
+}
+
+
+ParseError::ParseError(const std::size_t offset, const std::string &message)
+    : std::runtime_error("offset " + std::to_string(offset) + ": " + message),
+      offset_(offset)
+{
+}
+
+
+std::size_t
+ParseError::offset() const noexcept
+{
+    return offset_;
+}
+
+
+Value
+parse(const std::string_view text)
+{
+    return Parser(text).parseDocument();
+}
+
+
+void
+write(std::ostream &output, const Value &value)
+{
+    if (value.isNull()) {
+        output << "null";
+    }
+    else if (value.isBool()) {
+        output << (value.asBool() ? "true" : "false");
+    }
+    else if (value.isNumber()) {
+        const auto number = value.asNumber();
+        char text[32];
+        if (std::trunc(number) == number and std::abs(number) < 9007199254740992.0) {
+            std::snprintf(text, sizeof(text), "%lld", static_cast<long long>(number));
+        }
+        else {
+            std::snprintf(text, sizeof(text), "%.17g", number);
+        }
+        output << text;
+    }
+    else if (value.isString()) {
+        writeString(output, value.asString());
+    }
+    else if (value.isArray()) {
+        output << '[';
+        const char *separator = "";
+        for (const auto &element : value.asArray()) {
+            output << separator;
+            write(output, element);
+            separator = ",";
+        }
+        output << ']';
+    }
+    else {
+        output << '{';
+        const char *separator = "";
+        for (const auto &[key, member_value] : value.asObject()) {
+            output << separator;
+            writeString(output, key);
+            output << ':';
+            write(output, member_value);
+            separator = ",";
+        }
+        output << '}';
+    }
+}
+
+
+std::string
+toString(const Value &value)
+{
+    std::ostringstream output;
+    write(output, value);
+    return output.str();
+}
+
+
+void
+writeString(std::ostream &output, const std::string_view text)
+{
+    output << '"';
+
+    std::size_t run_begin = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (c != '"' and c != '\\' and static_cast<unsigned char>(c) >= 0x20) {
+            continue;
+        }
+
+        output.write(text.data() + run_begin, static_cast<std::streamsize>(i - run_begin));
+        run_begin = i + 1;
+
+        switch (c) {
+        case '"':
+            output << "\\\"";
+            break;
+        case '\\':
+            output << "\\\\";
+            break;
+        case '\n':
+            output << "\\n";
+            break;
+        case '\r':
+            output << "\\r";
+            break;
+        case '\t':
+            output << "\\t";
+            break;
+        default: {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            output << escaped;
+        }
+        }
+    }
+    output.write(text.data() + run_begin, static_cast<std::streamsize>(text.size() - run_begin));
+
+    output << '"';
+}
+
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <lsp/Document.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace lsp
+{
+
+namespace
+{
+
+bool
+isContinuationByte(const char c)
+{
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+
+/*
+ * Characters outside the basic plane take two UTF-16 code units, they are
+ * the ones encoded with four bytes in UTF-8.
+ */
+std::size_t
+utf16Units(const char lead_byte)
+{
+    return static_cast<unsigned char>(lead_byte) >= 0xF0 ? 2 : 1;
+}
+
+}
+
+
+bool
+operator==(const Position &lhs, const Position &rhs)
+{
+    return lhs.line == rhs.line and lhs.character == rhs.character;
+}
+
+
+Document::Document(std::string text, const std::int64_t version, const PositionEncoding encoding)
+    : text_(std::move(text)),
+      version_(version),
+      encoding_(encoding)
+{
+}
+
+
+const std::string&
+Document::text() const noexcept
+{
+    return text_;
+}
+
+
+std::int64_t
+Document::version() const noexcept
+{
+    return version_;
+}
+
+
+std::size_t
+Document::offsetAt(const Position &position) const
+{
+    const auto &starts = lineStarts();
+    if (position.line >= starts.size()) {
+        return text_.size();
+    }
+
+    const auto begin = starts[position.line];
+    const auto end = lineEnd(position.line);
+
+    if (encoding_ == PositionEncoding::Utf8) {
+        return begin + std::min(position.character, end - begin);
+    }
+
+    auto offset = begin;
+    std::size_t units = 0;
+    while (offset < end and units < position.character) {
+        units += utf16Units(text_[offset]);
+        ++offset;
+        while (offset < end and isContinuationByte(text_[offset])) {
+            ++offset;
+        }
+    }
+
+    return offset;
+}
+
+
+Position
+Document::positionAt(std::size_t offset) const
+{
+    offset = std::min(offset, text_.size());
+
+    const auto &starts = lineStarts();
+    const auto line = static_cast<std::size_t>(
+        std::upper_bound(starts.cbegin(), starts.cend(), offset) - starts.cbegin() - 1);
+    const auto begin = starts[line];
+
+    if (encoding_ == PositionEncoding::Utf8) {
+        return Position {line, offset - begin};
+    }
+
+    std::size_t units = 0;
+    for (auto i = begin; i < offset; ++i) {
+        if (not isContinuationByte(text_[i])) {
+            units += utf16Units(text_[i]);
+        }
+    }
+
+    return Position {line, units};
+}
+
+
+std::size_t
+Document::lineCount() const
+{
+    return lineStarts().size();
+}
+
+
+void
+Document::replace(const Position &begin, const Position &end, const std::string_view text)
+{
+    const auto begin_offset = offsetAt(begin);
+    const auto end_offset = std::max(begin_offset, offsetAt(end));
+
+    text_.replace(begin_offset, end_offset - begin_offset, text);
+    is_indexed_ = false;
+}
+
+
+void
+Document::setText(std::string text)
+{
+    text_ = std::move(text);
+    is_indexed_ = false;
+}
+
+
+void
+Document::setVersion(const std::int64_t version) noexcept
+{
+    version_ = version;
+}
+
+
+const std::vector<std::size_t>&
+Document::lineStarts() const
+{
+    if (is_indexed_) {
+        return line_starts_;
+    }
+
+    line_starts_.clear();
+    line_starts_.push_back(0);
+
+    const char *const data = text_.data();
+    const auto size = text_.size();
+    std::size_t pos = 0;
+    while (pos < size) {
+        const auto *line_break = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        const auto lf = line_break ? static_cast<std::size_t>(line_break - data) : size;
+
+        for (auto *cr = static_cast<const char*>(std::memchr(data + pos, '\r', lf - pos));
+             cr != nullptr;
+             cr = static_cast<const char*>(std::memchr(cr + 1, '\r', static_cast<std::size_t>(data + lf - cr - 1)))) {
+            const auto line_start = static_cast<std::size_t>(cr - data) + 1;
+            if (line_start == size or data[line_start] != '\n') {
+                line_starts_.push_back(line_start);
+            }
+        }
+        if (lf == size) {
+            break;
+        }
+
+        line_starts_.push_back(lf + 1);
+        pos = lf + 1;
+    }
+
+    is_indexed_ = true;
+    return line_starts_;
+}
+
+
+std::size_t
+Document::lineEnd(const std::size_t line) const
+{
+    const auto &starts = lineStarts();
+    const auto begin = starts[line];
+    auto end = line + 1 < starts.size() ? starts[line + 1] : text_.size();
+
+    if (end > begin and text_[end - 1] == '\n') {
+        --end;
+    }
+    if (end > begin and text_[end - 1] == '\r') {
+        --end;
+    }
+
+    return end;
+}
+
+}
@@ -0,0 +1,501 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <lsp/Server.hpp>
+#include <lsp/Transport.hpp>
+
+#include <formatter/Budget.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <set>
+#include <stdexcept>
+
+
+namespace lsp
+{
+
+namespace
+{
+
+namespace error_code
+{
+
+constexpr int parse_error = -32700;
+constexpr int invalid_request = -32600;
+constexpr int method_not_found = -32601;
+constexpr int invalid_params = -32602;
+constexpr int server_not_initialized = -32002;
+constexpr int request_failed = -32803;
+
+}
+
+
+class ResponseError : public std::runtime_error
+{
+public:
+    ResponseError(const int code, const std::string &message)
+        : std::runtime_error(message),
+          code_(code)
+    {
+    }
+
+    int code() const noexcept
+    {
+        return code_;
+    }
+
+private:
+    int code_;
+};
+
+
+json::Value
+response(const json::Value &id, json::Value result)
+{
+    return json::Object {{"jsonrpc", "2.0"}, {"id", id}, {"result", std::move(result)}};
+}
+
+
+json::Value
+errorResponse(const json::Value &id, const int code, const std::string &message)
+{
+    return json::Object {{"jsonrpc", "2.0"},
+                         {"id", id},
+                         {"error", json::Object {{"code", code}, {"message", message}}}};
+}
+
+
+int
+hexDigitValue(const char c)
+{
+    if (c >= '0' and c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' and c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' and c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+
+/*
+ * Only local file URIs have a path, e.g. untitled documents are formatted
+ * with the default options.
+ */
+std::optional<std::filesystem::path>
+pathFromUri(std::string_view uri)
+{
+    constexpr std::string_view file_scheme = "file://";
+    if (uri.substr(0, file_scheme.size()) != file_scheme) {
+        return std::nullopt;
+    }
+    uri.remove_prefix(file_scheme.size());
+
+    const auto authority = uri.substr(0, uri.find('/'));
+    if (not authority.empty() and authority != "localhost") {
+        return std::nullopt;
+    }
+    uri.remove_prefix(authority.size());
+
+    std::string path;
+    for (std::size_t i = 0; i < uri.size(); ++i) {
+        if (uri[i] == '%' and i + 2 < uri.size()
+            and hexDigitValue(uri[i + 1]) >= 0 and hexDigitValue(uri[i + 2]) >= 0) {
+            path += static_cast<char>(hexDigitValue(uri[i + 1]) * 16 + hexDigitValue(uri[i + 2]));
+            i += 2;
+        }
+        else {
+            path += uri[i];
+        }
+    }
+
+    return std::filesystem::path(path);
+}
+
+
+std::size_t
+unsignedValue(const json::Value &value)
+{
+    const auto number = value.asInteger();
+    if (number < 0) {
+        throw json::TypeError("expected a non-negative integer");
+    }
+
+    return static_cast<std::size_t>(number);
+}
+
+
+Position
+positionFromJson(const json::Value &value)
+{
+    return Position {unsignedValue(value["line"]), unsignedValue(value["character"])};
+}
+
+
+json::Value
+positionToJson(const Position &position)
+{
+    return json::Object {{"line", position.line}, {"character", position.character}};
+}
+
+
+json::Value
+textEditToJson(const Document &document, const formatter::TextEdit &edit)
+{
+    return json::Object {
+        {"range", json::Object {{"start", positionToJson(document.positionAt(edit.offset))},
+                                {"end", positionToJson(document.positionAt(edit.offset + edit.length))}}},
+        {"newText", edit.replacement},
+    };
+}
+
+
+/*
+ * The on type formatting is triggered by the chars closing a block or
+ * a statement and by the line break, which closes the previous line.
+ */
+json::Value
+onTypeFormattingProvider(const formatter::FormatterOptions &options)
+{
+    std::set<char> trigger_chars = options.indentation.decrease_indentation_chars;
+    trigger_chars.insert(options.split.split_after_chars.cbegin(), options.split.split_after_chars.cend());
+    trigger_chars.insert('\n');
+
+    json::Array more_trigger_chars;
+    for (const char c : trigger_chars) {
+        more_trigger_chars.emplace_back(std::string(1, c));
+    }
+    json::Value first_trigger_char = more_trigger_chars.front();
+    more_trigger_chars.erase(more_trigger_chars.begin());
+
+    return json::Object {{"firstTriggerCharacter", std::move(first_trigger_char)},
+                         {"moreTriggerCharacter", std::move(more_trigger_chars)}};
+}
+
+}
+
+
+Server::Server(formatter::FormatterOptions default_options, config::FileSystem &file_system)
+    : default_options_{std::make_shared<const formatter::FormatterOptions>(default_options),
+                       formatter::detail::KeywordMatcher::compile(default_options.indentation)},
+      config_resolver_(std::move(default_options), file_system)
+{
+}
+
+
+int
+Server::run(std::istream &input, std::ostream &output)
+{
+    while (not is_exit_requested_) {
+        const auto content = readMessage(input);
+        if (not content) {
+            break;
+        }
+
+        std::optional<json::Value> reply;
+        try {
+            reply = handle(json::parse(*content));
+        }
+        catch (const json::ParseError &e) {
+            reply = errorResponse(nullptr, error_code::parse_error, e.what());
+        }
+
+        if (reply) {
+            writeMessage(output, json::toString(*reply));
+        }
+    }
+
+    return is_shutdown_requested_ ? 0 : 1;
+}
+
+
+std::optional<json::Value>
+Server::handle(const json::Value &message)
+{
+    const auto *id = message.find("id");
+    const auto &method = message["method"];
+
+    if (not method.isString()) {
+        if (id and (message.find("result") or message.find("error"))) {
+            return std::nullopt;
+        }
+        return errorResponse(id ? *id : json::Value(), error_code::invalid_request, "expected a request");
+    }
+
+    if (not id) {
+        try {
+            notify(method.asString(), message["params"]);
+        }
+        catch (const std::exception &) {
+            /*
+             * Notifications can not be answered, the document stays as it was.
+             */
+        }
+        return std::nullopt;
+    }
+
+    try {
+        return response(*id, call(method.asString(), message["params"]));
+    }
+    catch (const ResponseError &e) {
+        return errorResponse(*id, e.code(), e.what());
+    }
+    catch (const json::TypeError &e) {
+        return errorResponse(*id, error_code::invalid_params, e.what());
+    }
+    catch (const std::exception &e) {
+        return errorResponse(*id, error_code::request_failed, e.what());
+    }
+}
+
+
+bool
+Server::isExitRequested() const noexcept
+{
+    return is_exit_requested_;
+}
+
+
+json::Value
+Server::call(const std::string &method, const json::Value &params)
+{
+    if (method == "initialize") {
+        if (is_initialized_) {
+            throw ResponseError(error_code::invalid_request, "the server is already initialized");
+        }
+        return initialize(params);
+    }
+    if (not is_initialized_) {
+        throw ResponseError(error_code::server_not_initialized, "the server is not initialized");
+    }
+    if (is_shutdown_requested_) {
+        throw ResponseError(error_code::invalid_request, "the server is shutting down");
+    }
+
+    if (method == "shutdown") {
+        is_shutdown_requested_ = true;
+        documents_.clear();
+        return nullptr;
+    }
+    if (method == "textDocument/formatting") {
+        return formatting(params);
+    }
+    if (method == "textDocument/rangeFormatting") {
+        return rangeFormatting(params);
+    }
+    if (method == "textDocument/onTypeFormatting") {
+        return onTypeFormatting(params);
+    }
+
+    throw ResponseError(error_code::method_not_found, "unknown method: " + method);
+}
+
+
+void
+Server::notify(const std::string &method, const json::Value &params)
+{
+    if (method == "exit") {
+        is_exit_requested_ = true;
+    }
+    else if (not is_initialized_ or is_shutdown_requested_) {
+        return;
+    }
+    else if (method == "textDocument/didOpen") {
+        didOpen(params);
+    }
+    else if (method == "textDocument/didChange") {
+        didChange(params);
+    }
+    else if (method == "textDocument/didClose") {
+        didClose(params);
+    }
+}
+
+
+/*
+ * UTF-8 positions are used when the client supports them, they are
+ * the byte offsets in a line and need no conversion.
+ */
+json::Value
+Server::initialize(const json::Value &params)
+{
+    const auto &encodings = params["capabilities"]["general"]["positionEncodings"];
+    if (encodings.isArray()) {
+        const auto &offered = encodings.asArray();
+        if (std::find(offered.cbegin(), offered.cend(), json::Value("utf-8")) != offered.cend()) {
+            encoding_ = PositionEncoding::Utf8;
+        }
+    }
+
+    is_initialized_ = true;
+
+    json::Object capabilities {
+        {"positionEncoding", encoding_ == PositionEncoding::Utf8 ? "utf-8" : "utf-16"},
+        {"textDocumentSync", json::Object {{"openClose", true}, {"change", 2}}},
+        {"documentFormattingProvider", true},
+        {"documentRangeFormattingProvider", true},
+        {"documentOnTypeFormattingProvider", onTypeFormattingProvider(*default_options_.options)},
+    };
+
+    return json::Object {{"capabilities", std::move(capabilities)},
+                         {"serverInfo", json::Object {{"name", "code-formatter"}}}};
+}
+
+
+void
+Server::didOpen(const json::Value &params)
+{
+    const auto &text_document = params["textDocument"];
+    const auto &uri = text_document["uri"].asString();
+
+    documents_.insert_or_assign(uri, OpenDocument {
+        Document(text_document["text"].asString(), text_document["version"].asInteger(), encoding_),
+        pathFromUri(uri),
+        std::nullopt,
+        std::nullopt,
+    });
+}
+
+
+void
+Server::didChange(const json::Value &params)
+{
+    auto &open_document = openDocument(params);
+    auto &document = open_document.document;
+
+    for (const auto &change : params["contentChanges"].asArray()) {
+        if (const auto *range = change.find("range")) {
+            document.replace(positionFromJson((*range)["start"]), positionFromJson((*range)["end"]),
+                             change["text"].asString());
+        }
+        else {
+            document.setText(change["text"].asString());
+        }
+    }
+
+    document.setVersion(params["textDocument"]["version"].asInteger());
+    open_document.edits.reset();
+}
+
+
+void
+Server::didClose(const json::Value &params)
+{
+    documents_.erase(params["textDocument"]["uri"].asString());
+}
+
+
+json::Value
+Server::formatting(const json::Value &params)
+{
+    return editsOnLines(openDocument(params), 0, std::numeric_limits<std::size_t>::max());
+}
+
+
+/*
+ * A range ending at the beginning of a line does not include that line.
+ */
+json::Value
+Server::rangeFormatting(const json::Value &params)
+{
+    const auto begin = positionFromJson(params["range"]["start"]);
+    const auto end = positionFromJson(params["range"]["end"]);
+    const auto last_line = (end.character == 0 and end.line > begin.line) ? end.line - 1 : end.line;
+
+    return editsOnLines(openDocument(params), begin.line, last_line);
+}
+
+
+/*
+ * A typed line break formats the line it closed; the new line is left as
+ * it is, an empty line would lose the indentation added by the editor.
+ */
+json::Value
+Server::onTypeFormatting(const json::Value &params)
+{
+    const auto position = positionFromJson(params["position"]);
+    const auto line = (params["ch"].asString() == "\n" and position.line > 0) ? position.line - 1 : position.line;
+
+    return editsOnLines(openDocument(params), line, line);
+}
+
+
+Server::OpenDocument&
+Server::openDocument(const json::Value &params)
+{
+    const auto &uri = params["textDocument"]["uri"].asString();
+    const auto open_document = documents_.find(uri);
+    if (open_document == documents_.end()) {
+        throw ResponseError(error_code::invalid_params, "unknown document: " + uri);
+    }
+
+    return open_document->second;
+}
+
+
+/*
+ * The options are resolved on the first request, so an invalid config
+ * file is reported in its response. A document over the limits is left
+ * as it is.
+ */
+const std::vector<formatter::TextEdit>&
+Server::edits(OpenDocument &open_document)
+{
+    if (not open_document.edits) {
+        if (not open_document.options) {
+            open_document.options = open_document.path ? config_resolver_.resolveFile(*open_document.path)
+                                                       : default_options_;
+        }
+        try {
+            open_document.edits = formatter::formatEdits(open_document.document.text(),
+                                                         *open_document.options->options,
+                                                         open_document.options->keyword_matcher);
+        }
+        catch (const formatter::BudgetExceededError &) {
+            open_document.edits.emplace();
+        }
+    }
+
+    return *open_document.edits;
+}
+
+
+/*
+ * Every edit is confined to one line of the document, the edits of the
+ * lines are looked up by the offset of the first line.
+ */
+json::Value
+Server::editsOnLines(OpenDocument &open_document, const std::size_t first_line, const std::size_t last_line)
+{
+    const auto &document = open_document.document;
+    const auto &all_edits = edits(open_document);
+
+    const auto first_offset = document.offsetAt(Position {first_line, 0});
+    auto edit = std::lower_bound(all_edits.cbegin(), all_edits.cend(), first_offset,
+                                 [](const formatter::TextEdit &e, const std::size_t offset) {
+                                     return e.offset < offset;
+                                 });
+
+    json::Array result;
+    for (; edit != all_edits.cend(); ++edit) {
+        if (document.positionAt(edit->offset).line > last_line) {
+            break;
+        }
+        result.push_back(textEditToJson(document, *edit));
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <lsp/Transport.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+
+namespace lsp
+{
+
+namespace
+{
+
+constexpr std::string_view content_length_header = "content-length";
+constexpr std::size_t max_content_length = 256 * 1024 * 1024;
+
+
+bool
+equalsIgnoringCase(const std::string_view lhs, const std::string_view rhs)
+{
+    return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(),
+                      [](const char l, const char r) {
+                          return std::tolower(static_cast<unsigned char>(l)) == std::tolower(static_cast<unsigned char>(r));
+                      });
+}
+
+
+std::string_view
+trim(std::string_view text)
+{
+    while (not text.empty() and (text.front() == ' ' or text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (not text.empty() and (text.back() == ' ' or text.back() == '\t' or text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+}
+
+
+std::optional<std::string>
+readMessage(std::istream &input)
+{
+    std::optional<std::size_t> content_length;
+    bool has_headers = false;
+    std::string header;
+
+    while (true) {
+        if (not std::getline(input, header)) {
+            if (has_headers) {
+                throw ProtocolError("unexpected end of input in the message header");
+            }
+            return std::nullopt;
+        }
+
+        const auto line = trim(header);
+        if (line.empty()) {
+            if (not has_headers) {
+                continue;
+            }
+            break;
+        }
+        has_headers = true;
+
+        const auto colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            throw ProtocolError("invalid message header: " + std::string(line));
+        }
+        if (equalsIgnoringCase(trim(line.substr(0, colon)), content_length_header)) {
+            const auto value = trim(line.substr(colon + 1));
+            std::size_t length = 0;
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), length);
+            if (error != std::errc() or end != value.data() + value.size() or length > max_content_length) {
+                throw ProtocolError("invalid Content-Length: " + std::string(value));
+            }
+            content_length = length;
+        }
+    }
+
+    if (not content_length) {
+        throw ProtocolError("missing Content-Length header");
+    }
+
+    std::string content(*content_length, '\0');
+    if (not input.read(content.data(), static_cast<std::streamsize>(content.size()))) {
+        throw ProtocolError("unexpected end of input in the message content");
+    }
+
+    return content;
+}
+
+
+void
+writeMessage(std::ostream &output, const std::string_view content)
+{
+    output << "Content-Length: " << content.size() << "\r\n\r\n" << content;
+    output.flush();
+}
+
+}
@@ -6,37 +6,507 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
-#include <fstream>
+#include <mutex>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <sstream>
 
 #include <FileContent.hpp>
+#include <cli/Arguments.hpp>
+#include <config/ConfigResolver.hpp>
+#include <diff/UnifiedDiff.hpp>
 #include <formatter/Formatter.hpp>
+#include <formatter/TextEdits.hpp>
+#include <git/ChangedLines.hpp>
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+#include <json/Json.hpp>
+#include <lsp/Server.hpp>
+#include <memory/Arena.hpp>
+#include <pipeline/Pipeline.hpp>
+#include <trace/Tracer.hpp>
+#include <traversal/DirectoryWalker.hpp>
+#include <traversal/GlobPattern.hpp>
+#include <watch/WatchSession.hpp>
+#include <watch/Watcher.hpp>
 
 
 namespace
 {
 
-FileContent readFile(const char *name)
+std::mutex output_mutex;
+
+struct RunStatistics
+{
+    std::atomic<std::size_t> files {0};
+    std::atomic<std::size_t> skipped_files {0};
+    std::atomic<std::size_t> arena_allocations {0};
+    std::atomic<std::size_t> arena_bytes {0};
+    std::atomic<std::size_t> files_using_heap {0};
+    std::atomic<std::size_t> heap_allocations {0};
+    std::atomic<std::size_t> bytes {0};
+    std::atomic<std::size_t> unchanged_bytes {0};
+};
+
+RunStatistics run_statistics;
+
+std::unique_ptr<trace::Tracer> tracer;
+
+
+formatter::FormatterOptions
+defaultOptions(const cli::Arguments &arguments)
 {
-    FileContent content;
+    formatter::FormatterOptions options;
+    options.indentation.increase_indentation_chars = {'{', '('};
+    options.indentation.decrease_indentation_chars = {'}', ')'} ;
+    options.indentation.num_of_spaces = 4;
+    options.indentation.reduce_indent_for_last_decrease_char = true;
+    options.limits.time = std::chrono::milliseconds(arguments.max_time_ms);
+    options.limits.bytes = arguments.max_bytes;
+    options.limits.lines = arguments.max_lines;
+    options.limits.indentation_depth = arguments.max_depth;
 
-    auto f = std::ifstream(name, std::ios::binary);
-    f.exceptions(std::ifstream::failbit);
+    return options;
+}
 
-    Line line;
-    char c;
-    while (f.peek() != std::ifstream::traits_type::eof()) {
-        f.get(c);
-        if (c == '\n') {
-            content.push_back(line);
-            line.clear();
+
+/*
+ * Absolute paths are shown relative to the working directory, so the
+ * diff can be applied with patch -p0 from there.
+ */
+std::string
+diffLabel(const std::string &name)
+{
+    const std::filesystem::path path(name);
+    if (path.is_absolute()) {
+        const auto relative_path = path.lexically_relative(std::filesystem::current_path());
+        if (not relative_path.empty()) {
+            return relative_path.string();
+        }
+    }
+
+    return name;
+}
+
+
+/*
+ * Prints a line like {"file":"a.c","edits":[{"offset":4,"length":0,"text":"  "}]},
+ * the offsets are in bytes of the file.
+ */
+void
+writeEdits(std::ostream &output, const std::string &name, const std::vector<formatter::TextEdit> &edits)
+{
+    output << "{\"file\":";
+    json::writeString(output, name);
+    output << ",\"edits\":[";
+
+    const char *separator = "";
+    for (const auto &edit : edits) {
+        output << separator << "{\"offset\":" << edit.offset << ",\"length\":" << edit.length << ",\"text\":";
+        json::writeString(output, edit.replacement);
+        output << '}';
+        separator = ",";
+    }
+
+    output << "]}\n";
+}
+
+
+void
+addFormatStatistics(const formatter::FormatStatistics &format_statistics)
+{
+    run_statistics.bytes += format_statistics.bytes;
+    run_statistics.unchanged_bytes += format_statistics.unchanged_bytes;
+}
+
+
+void
+reportSkippedFile(const std::string &name, const formatter::BudgetExceededError &e)
+{
+    ++run_statistics.skipped_files;
+    std::lock_guard<std::mutex> lock(output_mutex);
+    std::cerr << name << ": skipped: " << e.what() << '\n';
+}
+
+
+/*
+ * Prints a skipped file as it is, so the output still has all the files.
+ */
+bool
+passFileThrough(const std::string &name, std::pmr::memory_resource *resource)
+{
+    try {
+        const auto input = io::readRawFile(name.c_str(), resource);
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cout.write(input.data(), static_cast<std::streamsize>(input.size()));
+    }
+    catch (const std::exception &e) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cerr << name << ": error: " << e.what() << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * The output for the standard output is collected first, so the other
+ * files are formatted meanwhile and a file over the limits can still be
+ * passed through.
+ */
+bool
+formatFileInPipeline(const std::string &name,
+                     const cli::Arguments &arguments,
+                     config::ConfigResolver &config_resolver)
+{
+    trace::Span span(tracer.get(), "file", name);
+
+    try {
+        const auto resolved_options = config_resolver.resolveFile(name);
+        const auto &options = resolved_options.options;
+        pipeline::PipelineOptions pipeline_options;
+        pipeline_options.tracer = tracer.get();
+        pipeline_options.keyword_matcher = resolved_options.keyword_matcher;
+
+        if (arguments.in_place) {
+            io::writeFile(name, [&](std::ostream &output) {
+                addFormatStatistics(pipeline::formatFile(name.c_str(), *options, output, pipeline_options));
+            });
         }
         else {
-            line.append(&c, 1);
+            std::ostringstream output;
+            addFormatStatistics(pipeline::formatFile(name.c_str(), *options, output, pipeline_options));
+            std::lock_guard<std::mutex> lock(output_mutex);
+            std::cout << output.str();
         }
     }
+    catch (const formatter::BudgetExceededError &e) {
+        reportSkippedFile(name, e);
+        if (not arguments.in_place and not passFileThrough(name, std::pmr::get_default_resource())) {
+            return false;
+        }
+    }
+    catch (const std::exception &e) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cerr << name << ": error: " << e.what() << '\n';
+        return false;
+    }
 
-    return content;
+    ++run_statistics.files;
+    return true;
+}
+
+
+/*
+ * A file over the limits of its options is left unchanged and reported
+ * as skipped.
+ */
+bool
+formatFileInArena(const std::string &name,
+                  const cli::Arguments &arguments,
+                  config::ConfigResolver &config_resolver,
+                  const std::vector<LineRange> *line_ranges,
+                  memory::Arena &arena)
+{
+    try {
+        const auto resolved_options = config_resolver.resolveFile(name);
+        const auto &options = *resolved_options.options;
+        const auto &keyword_matcher = resolved_options.keyword_matcher;
+
+        if (options.limits.bytes > 0) {
+            formatter::Budget(options.limits).checkInputSize(std::filesystem::file_size(name));
+        }
+
+        if (arguments.edits) {
+            const auto input = [&] {
+                trace::Span span(tracer.get(), "read");
+                return io::readRawFile(name.c_str(), &arena);
+            }();
+            const auto edits = [&] {
+                trace::Span span(tracer.get(), "format");
+                return formatter::formatEdits(input, options, keyword_matcher);
+            }();
+
+            if (not edits.empty()) {
+                trace::Span span(tracer.get(), "write");
+                std::lock_guard<std::mutex> lock(output_mutex);
+                writeEdits(std::cout, name, edits);
+            }
+            return true;
+        }
+
+        io::TextFormat text_format;
+        auto file_content = [&] {
+            trace::Span span(tracer.get(), "read");
+            return io::readFile(name.c_str(), text_format, &arena);
+        }();
+
+        std::optional<FileContent> original_content;
+        if (arguments.diff) {
+            original_content.emplace(file_content, &arena);
+        }
+
+        {
+            trace::Span span(tracer.get(), "format");
+            if (line_ranges) {
+                formatter::format(file_content, options, *line_ranges, keyword_matcher);
+            }
+            else {
+                addFormatStatistics(formatter::format(file_content, options, keyword_matcher));
+            }
+        }
+
+        if (arguments.diff) {
+            const auto label = diffLabel(name);
+            const auto diff_text = [&] {
+                trace::Span span(tracer.get(), "diff");
+                return diff::unifiedDiff(*original_content, file_content, text_format, label, label);
+            }();
+            trace::Span span(tracer.get(), "write");
+            std::lock_guard<std::mutex> lock(output_mutex);
+            std::cout << diff_text;
+        }
+        else if (arguments.mapped_output) {
+            trace::Span span(tracer.get(), "write");
+            /*
+             * The walker already runs a file per thread, only the changed
+             * files of --git-base are formatted one by one.
+             */
+            io::MappedWriteOptions write_options;
+            write_options.threads = line_ranges ? arguments.jobs : 1;
+            io::writeFileMapped(name, file_content, text_format, write_options);
+        }
+        else if (arguments.in_place or line_ranges) {
+            trace::Span span(tracer.get(), "write");
+            io::writeFile(name, file_content, text_format);
+        }
+        else {
+            trace::Span span(tracer.get(), "write");
+            std::lock_guard<std::mutex> lock(output_mutex);
+            io::writeContent(std::cout, file_content, text_format);
+        }
+    }
+    catch (const formatter::BudgetExceededError &e) {
+        reportSkippedFile(name, e);
+        if (not (arguments.edits or arguments.diff or arguments.in_place or line_ranges)) {
+            return passFileThrough(name, &arena);
+        }
+    }
+    catch (const std::exception &e) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cerr << name << ": error: " << e.what() << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * Every worker thread formats its files inside its own arena, released
+ * in one step after each file.
+ */
+bool
+formatFile(const std::string &name,
+           const cli::Arguments &arguments,
+           config::ConfigResolver &config_resolver,
+           const std::vector<LineRange> *line_ranges = nullptr)
+{
+    thread_local memory::Arena arena;
+    trace::Span span(tracer.get(), "file", name);
+
+    const bool success = formatFileInArena(name, arguments, config_resolver, line_ranges, arena);
+
+    const auto arena_statistics = arena.statistics();
+    ++run_statistics.files;
+    run_statistics.arena_allocations += arena_statistics.cycle_allocations;
+    run_statistics.arena_bytes += arena_statistics.cycle_bytes;
+    if (arena_statistics.cycle_upstream_allocations > 0) {
+        ++run_statistics.files_using_heap;
+        run_statistics.heap_allocations += arena_statistics.cycle_upstream_allocations;
+    }
+
+    arena.reset();
+    return success;
+}
+
+
+void
+printStatistics()
+{
+    std::cerr << "files: " << run_statistics.files << '\n'
+              << "skipped files: " << run_statistics.skipped_files << '\n'
+              << "arena allocations: " << run_statistics.arena_allocations
+              << " (" << run_statistics.arena_bytes << " bytes)\n"
+              << "files exceeding the arena: " << run_statistics.files_using_heap
+              << " (" << run_statistics.heap_allocations << " heap allocations)\n"
+              << "already formatted bytes: " << run_statistics.unchanged_bytes
+              << " of " << run_statistics.bytes;
+    if (run_statistics.bytes > 0) {
+        std::cerr << " (" << 100 * run_statistics.unchanged_bytes / run_statistics.bytes << "%)";
+    }
+    std::cerr << '\n';
+}
+
+
+/*
+ * The files are formatted in parallel, their content would be mixed on
+ * the standard output, so only a single file is written there. The diffs
+ * and edits name their files.
+ */
+bool
+writesManyFilesToStdout(const cli::Arguments &arguments)
+{
+    if (arguments.in_place or arguments.diff or arguments.edits) {
+        return false;
+    }
+
+    std::error_code error;
+    return arguments.files.size() > 1 or std::filesystem::is_directory(arguments.files.front(), error);
+}
+
+
+bool
+formatFiles(const cli::Arguments &arguments, config::ConfigResolver &config_resolver)
+{
+    traversal::WalkerOptions walker_options;
+    walker_options.include_patterns = arguments.include_patterns;
+    walker_options.exclude_patterns = arguments.exclude_patterns;
+    walker_options.threads = arguments.jobs;
+    walker_options.on_error = [](const std::filesystem::path &path, const std::error_code &error) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::cerr << path.string() << ": error: " << error.message() << '\n';
+    };
+
+    const std::vector<std::filesystem::path> paths(arguments.files.cbegin(), arguments.files.cend());
+    std::atomic<bool> success {true};
+
+    traversal::DirectoryWalker(std::move(walker_options)).walk(paths, [&](const std::filesystem::path &path) {
+        const bool success_for_file = arguments.pipeline
+            ? formatFileInPipeline(path.string(), arguments, config_resolver)
+            : formatFile(path.string(), arguments, config_resolver);
+        if (not success_for_file) {
+            success = false;
+        }
+    });
+
+    return success;
+}
+
+
+bool
+isSelected(const std::filesystem::path &path, const std::vector<std::filesystem::path> &selected_paths)
+{
+    if (selected_paths.empty()) {
+        return true;
+    }
+
+    for (const auto &selected_path : selected_paths) {
+        const auto mismatch = std::mismatch(selected_path.begin(), selected_path.end(),
+                                            path.begin(), path.end());
+        if (mismatch.first == selected_path.end()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+bool
+formatChangedLines(const cli::Arguments &arguments, config::ConfigResolver &config_resolver)
+{
+    const auto root = std::filesystem::path(git::repositoryRoot("."));
+    const auto changed_lines = git::changedLines(root.string(), *arguments.git_base);
+
+    std::vector<std::filesystem::path> selected_paths;
+    for (const auto &file : arguments.files) {
+        selected_paths.push_back(std::filesystem::weakly_canonical(file));
+    }
+
+    bool success = true;
+    for (const auto &[relative_path, line_ranges] : changed_lines) {
+        const auto path = std::filesystem::weakly_canonical(root / relative_path);
+        if (isSelected(path, selected_paths)) {
+            success = formatFile(path.string(), arguments, config_resolver, &line_ranges) and success;
+        }
+    }
+
+    return success;
+}
+
+
+bool
+isWatchedFile(const std::filesystem::path &path,
+              const std::vector<traversal::GlobPattern> &include_patterns,
+              const std::vector<traversal::GlobPattern> &exclude_patterns)
+{
+    const auto file_name = path.filename().string();
+    const auto matches = [&file_name](const traversal::GlobPattern &pattern) {
+        return pattern.matches(file_name);
+    };
+
+    if (file_name.size() >= io::temporary_file_suffix.size()
+        and file_name.compare(file_name.size() - io::temporary_file_suffix.size(),
+                              std::string::npos, io::temporary_file_suffix) == 0) {
+        return false;
+    }
+
+    return (include_patterns.empty() or std::any_of(include_patterns.cbegin(), include_patterns.cend(), matches))
+        and std::none_of(exclude_patterns.cbegin(), exclude_patterns.cend(), matches);
+}
+
+
+[[noreturn]] void
+watchFiles(const cli::Arguments &arguments, config::ConfigResolver &config_resolver)
+{
+    using namespace std::chrono_literals;
+
+    const std::vector<traversal::GlobPattern> include_patterns(arguments.include_patterns.cbegin(),
+                                                               arguments.include_patterns.cend());
+    const std::vector<traversal::GlobPattern> exclude_patterns(arguments.exclude_patterns.cbegin(),
+                                                               arguments.exclude_patterns.cend());
+
+    watch::Watcher watcher;
+    for (const auto &file : arguments.files) {
+        watcher.addPath(file);
+    }
+
+    watch::WatchSession session(config_resolver);
+
+    while (true) {
+        const auto events = watcher.waitForChanges(std::chrono::milliseconds(arguments.debounce_ms), 1h);
+
+        for (const auto &event : events) {
+            if (not isWatchedFile(event.path, include_patterns, exclude_patterns)) {
+                continue;
+            }
+
+            try {
+                const auto report = session.handle(event);
+                if (report.result == watch::EventReport::Result::OwnWrite) {
+                    continue;
+                }
+
+                std::cerr << event.path.string() << ": formatted "
+                          << report.formatted_lines << " of " << report.total_lines << " lines in "
+                          << report.format_time.count() << " us, latency "
+                          << report.latency.count() << " us"
+                          << (report.result == watch::EventReport::Result::AlreadyFormatted ? ", no changes" : "")
+                          << '\n';
+            }
+            catch (const std::exception &e) {
+                std::cerr << event.path.string() << ": error: " << e.what() << '\n';
+            }
+        }
+    }
 }
 
 }
@@ -44,21 +514,73 @@ FileContent readFile(const char *name)
 
 int main(int argc, char *argv[])
 {
-    const char *input_file = argv[1];
+    cli::Arguments arguments;
+    try {
+        arguments = cli::parseArguments(argc, argv);
+    }
+    catch (const cli::InvalidArgumentError &e) {
+        std::cerr << argv[0] << ": " << e.what() << "\n\n" << cli::usage(argv[0]);
+        return 2;
+    }
 
-    auto file_content = readFile(input_file);
+    if (arguments.trace_file) {
+        tracer = std::make_unique<trace::Tracer>();
+    }
 
-    formatter::FormatterOptions options;
-    options.indentation.increase_indentation_chars = {'{', '('};
-    options.indentation.decrease_indentation_chars = {'}', ')'} ;
-    options.indentation.num_of_spaces = 4;
-    options.indentation.reduce_indent_for_last_decrease_char = true;
+    config::LocalFileSystem file_system;
+    config::ConfigResolver config_resolver(defaultOptions(arguments), file_system);
+
+    bool success = true;
+    if (arguments.git_base) {
+        try {
+            success = formatChangedLines(arguments, config_resolver);
+        }
+        catch (const git::GitError &e) {
+            std::cerr << argv[0] << ": error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+    else if (arguments.lsp) {
+        std::ios::sync_with_stdio(false);
+        lsp::Server server(defaultOptions(arguments), file_system);
+        try {
+            return server.run(std::cin, std::cout);
+        }
+        catch (const std::exception &e) {
+            std::cerr << argv[0] << ": error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+    else if (arguments.watch) {
+        try {
+            watchFiles(arguments, config_resolver);
+        }
+        catch (const std::exception &e) {
+            std::cerr << argv[0] << ": error: " << e.what() << '\n';
+            return 1;
+        }
+    }
+    else if (writesManyFilesToStdout(arguments)) {
+        std::cerr << argv[0] << ": several files or a directory can be formatted only with -i, --diff or --edits\n";
+        return 2;
+    }
+    else {
+        success = formatFiles(arguments, config_resolver);
+    }
 
-    formatter::format(file_content, options);
+    if (arguments.stats) {
+        printStatistics();
+    }
 
-    for (const auto &line : file_content) {
-        std::cout << line << '\n';
+    if (tracer) {
+        try {
+            io::writeFile(*arguments.trace_file, [](std::ostream &output) { tracer->write(output); });
+        }
+        catch (const std::exception &e) {
+            std::cerr << *arguments.trace_file << ": error: " << e.what() << '\n';
+            success = false;
+        }
     }
 
-    return 0;
+    return success ? 0 : 1;
 }
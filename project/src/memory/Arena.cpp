@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory/Arena.hpp>
+
+#include <algorithm>
+
+
+namespace memory
+{
+
+namespace
+{
+
+constexpr std::size_t buffer_alignment = alignof(std::max_align_t);
+
+}
+
+
+Arena::Arena(const std::size_t initial_capacity, std::pmr::memory_resource *upstream)
+    : upstream_(upstream)
+{
+    allocateBuffer(std::max<std::size_t>(initial_capacity, buffer_alignment));
+}
+
+
+Arena::~Arena()
+{
+    monotonic_.reset();
+    upstream_.deallocate(buffer_, capacity_, buffer_alignment);
+}
+
+
+void
+Arena::reset()
+{
+    const bool has_overflowed = upstream_.statistics().allocations > cycle_upstream_start_;
+
+    monotonic_->release();
+
+    if (has_overflowed) {
+        const auto needed_capacity = cycle_bytes_ + cycle_bytes_ / 4;
+        const auto new_capacity = std::max(capacity_ * 2, needed_capacity);
+
+        monotonic_.reset();
+        upstream_.deallocate(buffer_, capacity_, buffer_alignment);
+        allocateBuffer(new_capacity);
+    }
+
+    ++resets_;
+    cycle_allocations_ = 0;
+    cycle_bytes_ = 0;
+    cycle_upstream_start_ = upstream_.statistics().allocations;
+}
+
+
+ArenaStatistics
+Arena::statistics() const noexcept
+{
+    ArenaStatistics statistics;
+    statistics.capacity = capacity_;
+    statistics.resets = resets_;
+    statistics.upstream_allocations = upstream_.statistics().allocations;
+    statistics.upstream_bytes = upstream_.statistics().allocated_bytes;
+    statistics.cycle_allocations = cycle_allocations_;
+    statistics.cycle_bytes = cycle_bytes_;
+    statistics.cycle_upstream_allocations = upstream_.statistics().allocations - cycle_upstream_start_;
+
+    return statistics;
+}
+
+
+void*
+Arena::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    ++cycle_allocations_;
+    cycle_bytes_ += bytes + alignment - 1;
+
+    return monotonic_->allocate(bytes, alignment);
+}
+
+
+void
+Arena::do_deallocate(void *, std::size_t, std::size_t)
+{
+}
+
+
+bool
+Arena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+
+void
+Arena::allocateBuffer(const std::size_t capacity)
+{
+    buffer_ = upstream_.allocate(capacity, buffer_alignment);
+    capacity_ = capacity;
+    monotonic_.emplace(buffer_, capacity_, &upstream_);
+    cycle_upstream_start_ = upstream_.statistics().allocations;
+}
+
+}
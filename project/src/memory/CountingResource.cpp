@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <memory/CountingResource.hpp>
+
+
+namespace memory
+{
+
+CountingResource::CountingResource(std::pmr::memory_resource *upstream)
+    : upstream_(upstream)
+{
+}
+
+
+const AllocationStatistics&
+CountingResource::statistics() const noexcept
+{
+    return statistics_;
+}
+
+
+void
+CountingResource::resetStatistics() noexcept
+{
+    statistics_ = AllocationStatistics{};
+}
+
+
+void*
+CountingResource::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+    auto *p = upstream_->allocate(bytes, alignment);
+    ++statistics_.allocations;
+    statistics_.allocated_bytes += bytes;
+
+    return p;
+}
+
+
+void
+CountingResource::do_deallocate(void *p, const std::size_t bytes, const std::size_t alignment)
+{
+    ++statistics_.deallocations;
+    upstream_->deallocate(p, bytes, alignment);
+}
+
+
+bool
+CountingResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+}
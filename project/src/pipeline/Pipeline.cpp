@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <pipeline/Pipeline.hpp>
+#include <pipeline/SpscQueue.hpp>
+
+#include <FileContent.hpp>
+#include <formatter/Budget.hpp>
+#include <formatter/detail/FormatLine.hpp>
+#include <formatter/detail/UpdateIndentation.hpp>
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+#include <io/InputNormalizer.hpp>
+#include <memory/Arena.hpp>
+#include <trace/Tracer.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+namespace pipeline
+{
+
+namespace
+{
+
+constexpr std::string_view utf8_bom = "\xEF\xBB\xBF";
+
+
+/*
+ * Lines of a part of the file. All the memory of a block comes from its
+ * arena, released in one step when the block is reused.
+ */
+struct LineBlock
+{
+    explicit LineBlock(const std::size_t block_size)
+        : arena(2 * block_size),
+          lines(&arena)
+    {
+    }
+
+    void recycle()
+    {
+        lines.clear();
+        arena.reset();
+        is_last = false;
+    }
+
+    memory::Arena arena;
+    FileContent lines;
+    bool is_last {false};
+};
+
+using BlockQueue = SpscQueue<LineBlock*>;
+
+
+class Pipeline
+{
+public:
+    Pipeline(const char *name, const formatter::FormatterOptions &options, const PipelineOptions &pipeline_options)
+        : name_(name),
+          options_(options),
+          pipeline_options_(pipeline_options),
+          free_blocks_(pipeline_options.blocks),
+          read_blocks_(pipeline_options.blocks),
+          formatted_blocks_(pipeline_options.blocks)
+    {
+        for (std::size_t i = 0; i < pipeline_options.blocks; ++i) {
+            blocks_.push_back(std::make_unique<LineBlock>(pipeline_options.block_size));
+            auto *block = blocks_.back().get();
+            free_blocks_.tryPush(block);
+        }
+    }
+
+    formatter::FormatStatistics run(std::ostream &output)
+    {
+        std::thread reader([this] { runStage("reader", reader_error_, [this] { read(); }); });
+        std::thread formatter([this] { runStage("formatter", formatter_error_, [this] { format(); }); });
+        runStage("writer", writer_error_, [this, &output] { write(output); });
+
+        reader.join();
+        formatter.join();
+
+        for (const auto &error : {reader_error_, formatter_error_, writer_error_}) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        return statistics_;
+    }
+
+private:
+    /*
+     * The stage span holds the spans of the blocks, the gaps between them
+     * are the time spent waiting for the other stages.
+     */
+    template <typename Stage>
+    void runStage(const char *stage_name, std::exception_ptr &error, Stage stage)
+    {
+        trace::Span span(pipeline_options_.tracer, stage_name, name_);
+        try {
+            stage();
+        }
+        catch (...) {
+            error = std::current_exception();
+            is_cancelled_ = true;
+            notifyProgress();
+        }
+    }
+
+    /*
+     * Waits while the queue is full or empty. The stage yields a few times
+     * first, the blocks usually move quickly, and then sleeps until another
+     * stage moves a block, so a stage waiting for the disk does not burn
+     * the CPU. Returns false when another stage failed.
+     */
+    template <typename Operation>
+    bool waitFor(Operation operation)
+    {
+        for (int i = 0; i < spins_before_sleep; ++i) {
+            if (operation()) {
+                notifyProgress();
+                return true;
+            }
+            if (is_cancelled_) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+
+        bool is_done = false;
+        {
+            std::unique_lock<std::mutex> lock(progress_mutex_);
+            progress_.wait(lock, [&] {
+                is_done = is_done or operation();
+                return is_done or is_cancelled_;
+            });
+        }
+        if (is_done) {
+            notifyProgress();
+        }
+
+        return is_done;
+    }
+
+    /*
+     * The mutex is taken before notifying, so a stage checking its queue
+     * under it can not miss the change.
+     */
+    void notifyProgress()
+    {
+        {
+            std::lock_guard<std::mutex> lock(progress_mutex_);
+        }
+        progress_.notify_all();
+    }
+
+    bool push(BlockQueue &queue, LineBlock *block)
+    {
+        return waitFor([&] { return queue.tryPush(block); });
+    }
+
+    LineBlock* pop(BlockQueue &queue)
+    {
+        LineBlock *block = nullptr;
+        return waitFor([&] { return queue.tryPop(block); }) ? block : nullptr;
+    }
+
+    void read()
+    {
+        io::LineBlockReader reader(name_);
+        bool is_first_block = true;
+
+        while (true) {
+            auto *block = pop(free_blocks_);
+            if (not block) {
+                return;
+            }
+            block->recycle();
+
+            {
+                trace::Span span(pipeline_options_.tracer, "read");
+                readBlock(reader, *block, is_first_block);
+            }
+            is_first_block = false;
+
+            const bool is_last = block->is_last;
+            if (not push(read_blocks_, block) or is_last) {
+                return;
+            }
+        }
+    }
+
+    void readBlock(io::LineBlockReader &reader, LineBlock &block, const bool is_first_block)
+    {
+        std::pmr::string raw_block(&block.arena);
+        const auto offset = reader.readBlock(raw_block, pipeline_options_.block_size);
+
+        if (is_first_block) {
+            const auto normalized = io::normalizeInput(raw_block, &block.arena);
+            format_ = normalized.format;
+            block.lines = io::splitLines(normalized.text, &block.arena);
+        }
+        else if (not raw_block.empty()) {
+            const auto normalized = io::normalizeInputBlock(raw_block, offset, &block.arena);
+            format_.ends_with_newline = normalized.format.ends_with_newline;
+            block.lines = io::splitLines(normalized.text, &block.arena);
+        }
+
+        block.is_last = raw_block.empty();
+    }
+
+    void format()
+    {
+        const formatter::detail::Splitter splitter(options_.split);
+        formatter::detail::Indenter indenter(options_.indentation, pipeline_options_.keyword_matcher);
+        std::optional<formatter::Budget> budget;
+        if (formatter::hasLimits(options_.limits)) {
+            budget.emplace(options_.limits);
+        }
+
+        while (auto *block = pop(read_blocks_)) {
+            formatter::FormatStatistics block_statistics;
+            {
+                trace::Span span(pipeline_options_.tracer, "format");
+                block_statistics = formatter::detail::formatLines(block->lines, splitter, indenter,
+                                                                  budget ? &*budget : nullptr);
+            }
+            statistics_.lines += block_statistics.lines;
+            statistics_.bytes += block_statistics.bytes;
+            statistics_.unchanged_lines += block_statistics.unchanged_lines;
+            statistics_.unchanged_bytes += block_statistics.unchanged_bytes;
+
+            const bool is_last = block->is_last;
+            if (not push(formatted_blocks_, block) or is_last) {
+                return;
+            }
+        }
+    }
+
+    /*
+     * The line ending is written before the next line, so it is known
+     * whether the last line is followed by one.
+     */
+    void write(std::ostream &output)
+    {
+        bool is_first_block = true;
+        bool has_pending_line_ending = false;
+        std::string_view line_ending;
+
+        while (auto *block = pop(formatted_blocks_)) {
+            if (is_first_block) {
+                line_ending = io::lineEndingChars(format_.line_ending);
+                if (format_.has_bom) {
+                    output << utf8_bom;
+                }
+                is_first_block = false;
+            }
+
+            {
+                trace::Span span(pipeline_options_.tracer, "write");
+                for (const auto &line : block->lines) {
+                    if (has_pending_line_ending) {
+                        output << line_ending;
+                    }
+                    output << line;
+                    has_pending_line_ending = true;
+                }
+            }
+
+            if (block->is_last) {
+                if (has_pending_line_ending and format_.ends_with_newline) {
+                    output << line_ending;
+                }
+                return;
+            }
+
+            block->lines.clear();
+            if (not push(free_blocks_, block)) {
+                return;
+            }
+        }
+    }
+
+    const char *name_;
+    const formatter::FormatterOptions &options_;
+    const PipelineOptions pipeline_options_;
+
+    std::vector<std::unique_ptr<LineBlock>> blocks_;
+    BlockQueue free_blocks_;
+    BlockQueue read_blocks_;
+    BlockQueue formatted_blocks_;
+
+    static constexpr int spins_before_sleep = 64;
+
+    std::mutex progress_mutex_;
+    std::condition_variable progress_;
+    std::atomic<bool> is_cancelled_ {false};
+    std::exception_ptr reader_error_;
+    std::exception_ptr formatter_error_;
+    std::exception_ptr writer_error_;
+
+    io::TextFormat format_;
+    formatter::FormatStatistics statistics_;
+};
+
+}
+
+
+formatter::FormatStatistics
+formatFile(const char *name,
+           const formatter::FormatterOptions &options,
+           std::ostream &output,
+           const PipelineOptions &pipeline_options)
+{
+    Pipeline pipeline(name, options, pipeline_options);
+    return pipeline.run(output);
+}
+
+}
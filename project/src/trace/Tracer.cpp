@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <trace/Tracer.hpp>
+
+#include <json/Json.hpp>
+
+#include <array>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace trace
+{
+
+namespace
+{
+
+struct Event
+{
+    const char *name;
+    const std::string *file;
+    std::int64_t begin_ns;
+    std::int64_t duration_ns;
+};
+
+constexpr std::size_t events_per_chunk = 1024;
+using EventChunk = std::array<Event, events_per_chunk>;
+
+std::atomic<std::uint64_t> next_tracer_id {1};
+
+
+/*
+ * The trace event timestamps are in microseconds, the fraction keeps
+ * the nanoseconds.
+ */
+void
+writeMicroseconds(std::ostream &output, const std::int64_t ns)
+{
+    char text[32];
+    std::snprintf(text, sizeof(text), "%lld.%03lld",
+                  static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+    output << text;
+}
+
+}
+
+
+struct Tracer::ThreadBuffer
+{
+    explicit ThreadBuffer(const std::uint32_t thread_number)
+        : thread_number(thread_number)
+    {
+    }
+
+    void append(const Event &event)
+    {
+        if (chunks.empty() or last_chunk_size == events_per_chunk) {
+            chunks.push_back(std::make_unique<EventChunk>());
+            last_chunk_size = 0;
+        }
+        (*chunks.back())[last_chunk_size++] = event;
+    }
+
+    template <typename Function>
+    void forEachEvent(Function function) const
+    {
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            const auto size = i + 1 == chunks.size() ? last_chunk_size : events_per_chunk;
+            for (std::size_t j = 0; j < size; ++j) {
+                function((*chunks[i])[j]);
+            }
+        }
+    }
+
+    const std::uint32_t thread_number;
+    std::vector<std::unique_ptr<EventChunk>> chunks;
+    std::size_t last_chunk_size {0};
+    std::deque<std::string> files;
+    const std::string *current_file {nullptr};
+    ThreadBuffer *next {nullptr};
+};
+
+
+Tracer::Tracer()
+    : id_(next_tracer_id++),
+      start_(Clock::now())
+{
+}
+
+
+Tracer::~Tracer()
+{
+    auto *buffer = buffers_.load();
+    while (buffer) {
+        delete std::exchange(buffer, buffer->next);
+    }
+}
+
+
+const std::string*
+Tracer::enterFile(const std::string_view name)
+{
+    auto &buffer = threadBuffer();
+    const auto *previous_file = buffer.current_file;
+    buffer.current_file = &buffer.files.emplace_back(name);
+    return previous_file;
+}
+
+
+void
+Tracer::leaveFile(const std::string *previous_file) noexcept
+{
+    threadBuffer().current_file = previous_file;
+}
+
+
+void
+Tracer::record(const char *name, const Clock::time_point begin, const Clock::time_point end)
+{
+    auto &buffer = threadBuffer();
+    buffer.append(Event {
+        name,
+        buffer.current_file,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(begin - start_).count(),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+    });
+}
+
+
+void
+Tracer::write(std::ostream &output) const
+{
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char *separator = "\n";
+
+    for (const auto *buffer = buffers_.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        output << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << buffer->thread_number << ",\"args\":{\"name\":\"thread " << buffer->thread_number << "\"}}";
+        separator = ",\n";
+
+        buffer->forEachEvent([&](const Event &event) {
+            output << separator << "{\"name\":";
+            json::writeString(output, event.name);
+            output << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_number << ",\"ts\":";
+            writeMicroseconds(output, event.begin_ns);
+            output << ",\"dur\":";
+            writeMicroseconds(output, event.duration_ns);
+            if (event.file) {
+                output << ",\"args\":{\"file\":";
+                json::writeString(output, *event.file);
+                output << '}';
+            }
+            output << '}';
+        });
+    }
+
+    output << "\n]}\n";
+}
+
+
+/*
+ * The thread caches the buffer of the tracer it used last. Tracers are
+ * told apart by id, as a new tracer may reuse the address of a destroyed one.
+ */
+Tracer::ThreadBuffer&
+Tracer::threadBuffer()
+{
+    struct ThreadCache
+    {
+        std::uint64_t tracer_id {0};
+        ThreadBuffer *buffer {nullptr};
+    };
+    thread_local ThreadCache thread_cache;
+
+    if (thread_cache.tracer_id == id_) {
+        return *thread_cache.buffer;
+    }
+
+    auto *buffer = new ThreadBuffer(++threads_);
+    buffer->next = buffers_.load(std::memory_order_relaxed);
+    while (not buffers_.compare_exchange_weak(buffer->next, buffer,
+                                              std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    thread_cache = ThreadCache {id_, buffer};
+    return *buffer;
+}
+
+
+Span::Span(Tracer *tracer, const char *name) noexcept
+    : tracer_(tracer),
+      name_(name)
+{
+    if (tracer_) {
+        begin_ = Clock::now();
+    }
+}
+
+
+Span::Span(Tracer *tracer, const char *name, const std::string_view file)
+    : tracer_(tracer),
+      name_(name),
+      is_file_span_(tracer != nullptr)
+{
+    if (tracer_) {
+        previous_file_ = tracer_->enterFile(file);
+        begin_ = Clock::now();
+    }
+}
+
+
+Span::~Span()
+{
+    if (tracer_) {
+        try {
+            tracer_->record(name_, begin_, Clock::now());
+        }
+        catch (const std::bad_alloc &) {
+        }
+        if (is_file_span_) {
+            tracer_->leaveFile(previous_file_);
+        }
+    }
+}
+
+}
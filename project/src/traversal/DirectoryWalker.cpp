@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <traversal/DirectoryWalker.hpp>
+#include <traversal/IgnoreRules.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+
+namespace traversal
+{
+
+namespace
+{
+
+constexpr std::string_view git_directory_name = ".git";
+constexpr std::size_t files_per_task = 8;
+
+
+/*
+ * Ignore rules of a directory linked with the rules of its parents.
+ * Directories without own ignore files share the node of their parent.
+ */
+struct IgnoreChain
+{
+    IgnoreRules rules;
+    std::string base_relative_path;
+    std::shared_ptr<const IgnoreChain> parent;
+};
+
+
+/*
+ * Scans the directory or, when it carries files, passes them to the
+ * callback. The found files and the files given directly are queued in
+ * small batches, so the files of one directory are spread over the threads.
+ */
+struct DirectoryTask
+{
+    std::filesystem::path path;
+    std::string relative_path;
+    std::shared_ptr<const IgnoreChain> ignore_chain;
+    std::vector<std::filesystem::path> files;
+};
+
+
+void
+appendFileTasks(std::vector<std::filesystem::path> files, std::vector<DirectoryTask> &tasks)
+{
+    for (std::size_t begin = 0; begin < files.size(); begin += files_per_task) {
+        const auto end = std::min(begin + files_per_task, files.size());
+        tasks.push_back(DirectoryTask{{}, {}, nullptr, {std::make_move_iterator(files.begin() + begin),
+                                                        std::make_move_iterator(files.begin() + end)}});
+    }
+}
+
+
+std::string_view
+relativeTo(const std::string_view path, const std::string &base)
+{
+    if (base.empty()) {
+        return path;
+    }
+
+    return path.substr(base.size() + 1);
+}
+
+
+bool
+isIgnored(const IgnoreChain *chain, const std::string_view relative_path, const bool is_directory)
+{
+    for (; chain != nullptr; chain = chain->parent.get()) {
+        const auto match = chain->rules.match(relativeTo(relative_path, chain->base_relative_path),
+                                              is_directory);
+        if (match != IgnoreRules::Match::None) {
+            return match == IgnoreRules::Match::Ignored;
+        }
+    }
+
+    return false;
+}
+
+
+bool
+matchesAny(const std::vector<GlobPattern> &patterns, const std::string_view relative_path,
+           const std::string_view file_name)
+{
+    for (const auto &pattern : patterns) {
+        const bool has_separator = pattern.pattern().find('/') != std::string::npos;
+        if (pattern.matches(has_separator ? relative_path : file_name)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+std::string
+readIgnoreFile(const std::filesystem::path &path)
+{
+    std::ifstream f(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f),
+                       std::istreambuf_iterator<char>());
+}
+
+
+class Walk
+{
+public:
+    Walk(const WalkerOptions &options,
+         const std::vector<GlobPattern> &include_patterns,
+         const std::vector<GlobPattern> &exclude_patterns,
+         const FileCallback &on_file)
+        : options_(options),
+          include_patterns_(include_patterns),
+          exclude_patterns_(exclude_patterns),
+          on_file_(on_file)
+    {
+    }
+
+    void push(DirectoryTask task)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(task));
+    }
+
+    void run(unsigned threads)
+    {
+        std::vector<std::thread> workers;
+        for (unsigned i = 1; i < threads; ++i) {
+            workers.emplace_back([this] { work(); });
+        }
+        work();
+
+        for (auto &worker : workers) {
+            worker.join();
+        }
+
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true) {
+            condition_.wait(lock, [this] {
+                return not pending_.empty() or active_ == 0 or error_;
+            });
+
+            if (pending_.empty() or error_) {
+                condition_.notify_all();
+                return;
+            }
+
+            auto task = std::move(pending_.back());
+            pending_.pop_back();
+            ++active_;
+            lock.unlock();
+
+            std::vector<DirectoryTask> found_tasks;
+            try {
+                if (task.files.empty()) {
+                    scan(task, found_tasks);
+                }
+                for (const auto &file : task.files) {
+                    on_file_(file);
+                }
+            }
+            catch (...) {
+                lock.lock();
+                if (not error_) {
+                    error_ = std::current_exception();
+                }
+                --active_;
+                condition_.notify_all();
+                return;
+            }
+
+            lock.lock();
+            --active_;
+            for (auto &found_task : found_tasks) {
+                pending_.push_back(std::move(found_task));
+            }
+            condition_.notify_all();
+        }
+    }
+
+    void reportError(const std::filesystem::path &path, const std::error_code &error) const
+    {
+        if (options_.on_error) {
+            options_.on_error(path, error);
+        }
+    }
+
+    std::shared_ptr<const IgnoreChain>
+    loadIgnoreFiles(const DirectoryTask &task) const
+    {
+        auto ignore_chain = task.ignore_chain;
+
+        for (const auto &ignore_file_name : options_.ignore_file_names) {
+            const auto ignore_file_path = task.path / ignore_file_name;
+            std::error_code error;
+            if (not std::filesystem::is_regular_file(ignore_file_path, error)) {
+                continue;
+            }
+
+            auto rules = IgnoreRules::parse(readIgnoreFile(ignore_file_path));
+            if (not rules.empty()) {
+                ignore_chain = std::make_shared<const IgnoreChain>(
+                    IgnoreChain{std::move(rules), task.relative_path, ignore_chain});
+            }
+        }
+
+        return ignore_chain;
+    }
+
+    /*
+     * Queues the subdirectories first and the batches of files on top of
+     * them, so the files are taken first and the queue holds the files of
+     * few directories at a time.
+     */
+    void scan(const DirectoryTask &task, std::vector<DirectoryTask> &found_tasks) const
+    {
+        std::vector<std::filesystem::path> files;
+
+        const auto ignore_chain = loadIgnoreFiles(task);
+
+        std::error_code error;
+        auto entry_it = std::filesystem::directory_iterator(task.path, error);
+        if (error) {
+            reportError(task.path, error);
+            return;
+        }
+
+        for (; entry_it != std::filesystem::directory_iterator(); entry_it.increment(error)) {
+            if (error) {
+                reportError(task.path, error);
+                break;
+            }
+
+            const auto &entry = *entry_it;
+            const auto file_name = entry.path().filename().string();
+            if (file_name == git_directory_name) {
+                continue;
+            }
+
+            std::error_code status_error;
+            const auto status = entry.symlink_status(status_error);
+            const bool is_directory = std::filesystem::is_directory(status);
+            if (not is_directory and not std::filesystem::is_regular_file(status)) {
+                continue;
+            }
+
+            auto relative_path = task.relative_path.empty()
+                                 ? file_name
+                                 : task.relative_path + "/" + file_name;
+
+            if (isIgnored(ignore_chain.get(), relative_path, is_directory)
+                or matchesAny(exclude_patterns_, relative_path, file_name)) {
+                continue;
+            }
+
+            if (is_directory) {
+                found_tasks.push_back(DirectoryTask{entry.path(), std::move(relative_path), ignore_chain, {}});
+            }
+            else if (include_patterns_.empty()
+                     or matchesAny(include_patterns_, relative_path, file_name)) {
+                files.push_back(entry.path());
+            }
+        }
+
+        appendFileTasks(std::move(files), found_tasks);
+    }
+
+    const WalkerOptions &options_;
+    const std::vector<GlobPattern> &include_patterns_;
+    const std::vector<GlobPattern> &exclude_patterns_;
+    const FileCallback &on_file_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<DirectoryTask> pending_;
+    unsigned active_ {0};
+    std::exception_ptr error_;
+};
+
+}
+
+
+DirectoryWalker::DirectoryWalker(WalkerOptions options)
+    : options_(std::move(options))
+{
+    for (const auto &pattern : options_.include_patterns) {
+        include_patterns_.emplace_back(pattern);
+    }
+    for (const auto &pattern : options_.exclude_patterns) {
+        exclude_patterns_.emplace_back(pattern);
+    }
+}
+
+
+void
+DirectoryWalker::walk(const std::vector<std::filesystem::path> &paths, const FileCallback &on_file) const
+{
+    Walk walk(options_, include_patterns_, exclude_patterns_, on_file);
+
+    std::vector<DirectoryTask> tasks;
+    std::vector<std::filesystem::path> files;
+    for (const auto &path : paths) {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error)) {
+            tasks.push_back(DirectoryTask{path, std::string(), nullptr, {}});
+        }
+        else {
+            files.push_back(path);
+        }
+    }
+    appendFileTasks(std::move(files), tasks);
+
+    for (auto &task : tasks) {
+        walk.push(std::move(task));
+    }
+
+    const auto threads = options_.threads > 0
+                         ? options_.threads
+                         : std::max(1u, std::thread::hardware_concurrency());
+    walk.run(threads);
+}
+
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <traversal/GlobPattern.hpp>
+
+
+namespace traversal
+{
+
+namespace
+{
+
+bool
+isSpecialChar(const char c)
+{
+    return c == '*'
+        or c == '?'
+        or c == '['
+        or c == '\\';
+}
+
+
+bool
+hasSpecialChars(const std::string_view text)
+{
+    for (const char c : text) {
+        if (isSpecialChar(c)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ * Matches a single character against the character class starting at
+ * pattern (just after '['). On success the pattern is moved past ']'.
+ * Returns false when the class is not terminated, so '[' is treated as
+ * a literal.
+ */
+bool
+matchCharClass(std::string_view &pattern, const char c, bool &matched)
+{
+    std::size_t pos = 0;
+    bool negated = false;
+    if (pos < pattern.size() and (pattern[pos] == '!' or pattern[pos] == '^')) {
+        negated = true;
+        ++pos;
+    }
+
+    matched = false;
+    bool first = true;
+    while (pos < pattern.size() and (first or pattern[pos] != ']')) {
+        first = false;
+        const char range_begin = pattern[pos];
+        if (pos + 2 < pattern.size() and pattern[pos + 1] == '-' and pattern[pos + 2] != ']') {
+            const char range_end = pattern[pos + 2];
+            matched = matched or (c >= range_begin and c <= range_end);
+            pos += 3;
+        }
+        else {
+            matched = matched or c == range_begin;
+            ++pos;
+        }
+    }
+
+    if (pos >= pattern.size()) {
+        return false;
+    }
+
+    pattern.remove_prefix(pos + 1);
+    matched = matched != negated;
+    return true;
+}
+
+
+bool
+matchGlob(std::string_view pattern, std::string_view path)
+{
+    while (not pattern.empty()) {
+        if (pattern.substr(0, 2) == "**") {
+            auto rest = pattern.substr(2);
+            if (rest.empty()) {
+                return true;
+            }
+
+            if (rest.front() == '/') {
+                rest.remove_prefix(1);
+                if (matchGlob(rest, path)) {
+                    return true;
+                }
+                for (std::size_t i = 0; i < path.size(); ++i) {
+                    if (path[i] == '/' and matchGlob(rest, path.substr(i + 1))) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            for (std::size_t i = 0; i <= path.size(); ++i) {
+                if (matchGlob(rest, path.substr(i))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        if (pattern.front() == '*') {
+            const auto rest = pattern.substr(1);
+            for (std::size_t i = 0; i <= path.size(); ++i) {
+                if (matchGlob(rest, path.substr(i))) {
+                    return true;
+                }
+                if (i < path.size() and path[i] == '/') {
+                    break;
+                }
+            }
+            return false;
+        }
+
+        if (path.empty()) {
+            return false;
+        }
+
+        const char c = path.front();
+        if (pattern.front() == '?') {
+            if (c == '/') {
+                return false;
+            }
+            pattern.remove_prefix(1);
+        }
+        else if (pattern.front() == '[') {
+            auto class_pattern = pattern.substr(1);
+            bool matched;
+            if (matchCharClass(class_pattern, c, matched)) {
+                if (not matched or c == '/') {
+                    return false;
+                }
+                pattern = class_pattern;
+            }
+            else {
+                if (c != '[') {
+                    return false;
+                }
+                pattern.remove_prefix(1);
+            }
+        }
+        else {
+            if (pattern.front() == '\\' and pattern.size() > 1) {
+                pattern.remove_prefix(1);
+            }
+            if (pattern.front() != c) {
+                return false;
+            }
+            pattern.remove_prefix(1);
+        }
+
+        path.remove_prefix(1);
+    }
+
+    return path.empty();
+}
+
+}
+
+
+GlobPattern::GlobPattern(const std::string_view pattern)
+    : pattern_(pattern),
+      kind_(Kind::General)
+{
+    if (not hasSpecialChars(pattern)) {
+        kind_ = Kind::Literal;
+        literal_ = pattern;
+    }
+    else if (pattern.size() > 1
+             and pattern.front() == '*'
+             and not hasSpecialChars(pattern.substr(1))
+             and pattern.find('/') == std::string_view::npos) {
+        kind_ = Kind::Suffix;
+        literal_ = pattern.substr(1);
+    }
+}
+
+
+bool
+GlobPattern::matches(const std::string_view path) const
+{
+    switch (kind_) {
+    case Kind::Literal:
+        return path == literal_;
+    case Kind::Suffix:
+        return path.size() >= literal_.size()
+            and path.substr(path.size() - literal_.size()) == literal_
+            and path.substr(0, path.size() - literal_.size()).find('/') == std::string_view::npos;
+    case Kind::General:
+        break;
+    }
+
+    return matchGlob(pattern_, path);
+}
+
+
+const std::string&
+GlobPattern::pattern() const noexcept
+{
+    return pattern_;
+}
+
+}
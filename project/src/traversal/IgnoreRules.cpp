@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <traversal/IgnoreRules.hpp>
+
+#include <algorithm>
+
+
+namespace traversal
+{
+
+namespace
+{
+
+std::string_view
+stripTrailingSpaces(std::string_view text)
+{
+    while (not text.empty()
+           and (text.back() == ' ' or text.back() == '\t' or text.back() == '\r')) {
+        const bool is_escaped = text.size() > 1 and text[text.size() - 2] == '\\';
+        if (is_escaped) {
+            break;
+        }
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+
+std::string_view
+baseName(const std::string_view path)
+{
+    const auto separator_pos = path.rfind('/');
+    if (separator_pos == std::string_view::npos) {
+        return path;
+    }
+
+    return path.substr(separator_pos + 1);
+}
+
+}
+
+
+IgnoreRules
+IgnoreRules::parse(std::string_view content)
+{
+    IgnoreRules rules;
+
+    while (not content.empty()) {
+        auto line_end = content.find('\n');
+        if (line_end == std::string_view::npos) {
+            line_end = content.size();
+        }
+
+        rules.addRule(content.substr(0, line_end));
+        content.remove_prefix(std::min(line_end + 1, content.size()));
+    }
+
+    return rules;
+}
+
+
+void
+IgnoreRules::addRule(std::string_view rule)
+{
+    rule = stripTrailingSpaces(rule);
+    if (rule.empty() or rule.front() == '#') {
+        return;
+    }
+
+    bool negated = false;
+    if (rule.front() == '!') {
+        negated = true;
+        rule.remove_prefix(1);
+    }
+
+    bool directory_only = false;
+    if (not rule.empty() and rule.back() == '/') {
+        directory_only = true;
+        rule.remove_suffix(1);
+    }
+
+    const bool anchored = rule.find('/') != std::string_view::npos;
+    if (not rule.empty() and rule.front() == '/') {
+        rule.remove_prefix(1);
+    }
+
+    if (rule.empty()) {
+        return;
+    }
+
+    rules_.push_back(Rule{GlobPattern(rule), negated, directory_only, anchored});
+}
+
+
+IgnoreRules::Match
+IgnoreRules::match(const std::string_view relative_path, const bool is_directory) const
+{
+    const auto base_name = baseName(relative_path);
+
+    for (auto rule_it = rules_.crbegin(); rule_it != rules_.crend(); ++rule_it) {
+        if (rule_it->directory_only and not is_directory) {
+            continue;
+        }
+
+        const auto matched_path = rule_it->anchored ? relative_path : base_name;
+        if (rule_it->pattern.matches(matched_path)) {
+            return rule_it->negated ? Match::Included : Match::Ignored;
+        }
+    }
+
+    return Match::None;
+}
+
+
+bool
+IgnoreRules::empty() const noexcept
+{
+    return rules_.empty();
+}
+
+}
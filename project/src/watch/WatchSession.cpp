@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <watch/WatchSession.hpp>
+
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+
+#include <functional>
+#include <sstream>
+#include <string_view>
+
+
+namespace watch
+{
+
+namespace
+{
+
+std::size_t
+contentHash(const std::string_view content)
+{
+    return std::hash<std::string_view>{}(content);
+}
+
+
+std::chrono::microseconds
+elapsedSince(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+}
+
+
+WatchSession::WatchSession(config::ConfigResolver &config_resolver)
+    : config_resolver_(config_resolver)
+{
+}
+
+
+EventReport
+WatchSession::handle(const ChangeEvent &event)
+{
+    EventReport report;
+    auto &state = files_[event.path];
+
+    const auto raw_content = io::readRawFile(event.path.c_str());
+    const auto raw_hash = contentHash(raw_content);
+    if (state.has_written and raw_hash == state.written_hash) {
+        report.result = EventReport::Result::OwnWrite;
+        report.latency = elapsedSince(event.received);
+        return report;
+    }
+
+    const auto format_start = std::chrono::steady_clock::now();
+
+    const auto resolved_options = config_resolver_.resolveFile(event.path);
+    if (not state.formatter or state.options != resolved_options.options) {
+        state.options = resolved_options.options;
+        state.formatter = std::make_unique<formatter::IncrementalFormatter>(*resolved_options.options,
+                                                                            resolved_options.keyword_matcher);
+    }
+
+    const auto normalized = io::normalizeInput(raw_content);
+    const auto content = io::splitLines(normalized.text);
+    const auto formatted_content = state.formatter->format(content);
+
+    std::ostringstream output;
+    io::writeContent(output, formatted_content, normalized.format);
+    const auto formatted = output.str();
+
+    report.format_time = elapsedSince(format_start);
+    report.formatted_lines = state.formatter->lastFormattedLines();
+    report.total_lines = content.size();
+
+    if (std::string_view(formatted) == std::string_view(raw_content)) {
+        report.result = EventReport::Result::AlreadyFormatted;
+    }
+    else {
+        io::writeFile(event.path.string(), formatted);
+    }
+
+    state.formatter->acceptOutput();
+    state.written_hash = contentHash(formatted);
+    state.has_written = true;
+    report.latency = elapsedSince(event.received);
+
+    return report;
+}
+
+}
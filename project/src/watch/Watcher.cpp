@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <watch/Watcher.hpp>
+
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+
+namespace watch
+{
+
+namespace
+{
+
+constexpr uint32_t file_events = IN_CLOSE_WRITE | IN_MOVED_TO;
+constexpr uint32_t directory_events = file_events | IN_CREATE;
+
+
+[[noreturn]] void
+throwSystemError(const char *what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+
+bool
+waitForInput(const int fd, const std::chrono::milliseconds timeout)
+{
+    pollfd poll_fd {fd, POLLIN, 0};
+
+    int result;
+    do {
+        result = poll(&poll_fd, 1, static_cast<int>(timeout.count()));
+    } while (result < 0 and errno == EINTR);
+
+    if (result < 0) {
+        throwSystemError("poll");
+    }
+
+    return result > 0;
+}
+
+}
+
+
+Watcher::Watcher()
+    : inotify_fd_(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+    if (inotify_fd_ < 0) {
+        throwSystemError("inotify_init1");
+    }
+}
+
+
+Watcher::~Watcher()
+{
+    close(inotify_fd_);
+}
+
+
+void
+Watcher::addPath(const std::filesystem::path &path)
+{
+    const auto absolute_path = std::filesystem::absolute(path).lexically_normal();
+
+    if (std::filesystem::is_directory(absolute_path)) {
+        addDirectory(absolute_path, true);
+        return;
+    }
+
+    const auto parent = absolute_path.parent_path();
+    const int watch_descriptor = inotify_add_watch(inotify_fd_, parent.c_str(), file_events);
+    if (watch_descriptor < 0) {
+        throwSystemError("inotify_add_watch");
+    }
+
+    auto &directory = directories_[watch_descriptor];
+    if (directory.path.empty()) {
+        directory.path = parent;
+        directory.recursive = false;
+    }
+    directory.file_names.insert(absolute_path.filename().string());
+}
+
+
+void
+Watcher::addDirectory(const std::filesystem::path &directory, const bool recursive)
+{
+    const int watch_descriptor = inotify_add_watch(inotify_fd_, directory.c_str(), directory_events);
+    if (watch_descriptor < 0) {
+        throwSystemError("inotify_add_watch");
+    }
+
+    auto &watched_directory = directories_[watch_descriptor];
+    watched_directory.path = directory;
+    watched_directory.recursive = recursive;
+    watched_directory.file_names.clear();
+
+    if (recursive) {
+        std::error_code error;
+        for (auto it = std::filesystem::directory_iterator(directory, error);
+             not error and it != std::filesystem::directory_iterator();
+             it.increment(error)) {
+            if (it->is_directory(error) and not it->is_symlink(error)) {
+                addDirectory(it->path(), true);
+            }
+        }
+    }
+}
+
+
+bool
+Watcher::readEvents(std::map<std::filesystem::path, std::chrono::steady_clock::time_point> &changes)
+{
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+    bool has_read = false;
+
+    while (true) {
+        const auto length = read(inotify_fd_, buffer.data(), buffer.size());
+        if (length < 0) {
+            if (errno == EAGAIN or errno == EINTR) {
+                return has_read;
+            }
+            throwSystemError("read");
+        }
+        if (length == 0) {
+            return has_read;
+        }
+        has_read = true;
+
+        const auto now = std::chrono::steady_clock::now();
+        for (const char *pos = buffer.data(); pos < buffer.data() + length;) {
+            const auto *event = reinterpret_cast<const inotify_event*>(pos);
+            pos += sizeof(inotify_event) + event->len;
+
+            const auto directory_it = directories_.find(event->wd);
+            if (directory_it == directories_.end() or event->len == 0) {
+                continue;
+            }
+
+            const auto &directory = directory_it->second;
+            const std::string name = event->name;
+            const auto path = directory.path / name;
+
+            if (event->mask & IN_ISDIR) {
+                if (directory.recursive) {
+                    addDirectory(path, true);
+                }
+                continue;
+            }
+
+            if (not (event->mask & file_events)) {
+                continue;
+            }
+
+            if (not directory.recursive and directory.file_names.count(name) == 0) {
+                continue;
+            }
+
+            changes.emplace(path, now);
+        }
+    }
+}
+
+
+std::vector<ChangeEvent>
+Watcher::waitForChanges(const std::chrono::milliseconds debounce,
+                        const std::chrono::milliseconds timeout)
+{
+    std::map<std::filesystem::path, std::chrono::steady_clock::time_point> changes;
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (changes.empty()) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0 or not waitForInput(inotify_fd_, remaining)) {
+            return {};
+        }
+        readEvents(changes);
+    }
+
+    while (waitForInput(inotify_fd_, debounce)) {
+        readEvents(changes);
+    }
+
+    std::vector<ChangeEvent> events;
+    for (const auto &[path, received] : changes) {
+        events.push_back(ChangeEvent{path, received});
+    }
+
+    return events;
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <formatter/FormatterOptions.hpp>
+
+
+/*
+ * Options shared by the tests, the braces and parentheses indent the
+ * blocks by four spaces. The tests change only what they check.
+ */
+inline formatter::FormatterOptions
+testsOptions()
+{
+    formatter::FormatterOptions options;
+    options.indentation.increase_indentation_chars = {'{', '('};
+    options.indentation.decrease_indentation_chars = {'}', ')'};
+    options.indentation.num_of_spaces = 4;
+    options.indentation.reduce_indent_for_last_decrease_char = true;
+
+    return options;
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <batch/BatchFormatter.hpp>
+#include <batch/ThreadPool.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+
+/*
+ * Runs every submitted task at once on the calling thread.
+ */
+class CountingExecutor : public batch::Executor
+{
+public:
+    unsigned concurrency() const noexcept override
+    {
+        return 4;
+    }
+
+    void submit(std::function<void()> task) override
+    {
+        ++submitted_tasks;
+        task();
+    }
+
+    unsigned submitted_tasks {0};
+};
+
+
+class FailingExecutor : public batch::Executor
+{
+public:
+    unsigned concurrency() const noexcept override
+    {
+        return 4;
+    }
+
+    void submit(std::function<void()>) override
+    {
+        throw std::runtime_error("executor is stopped");
+    }
+};
+
+}
+
+
+struct BatchFormatterTests : ::testing::Test
+{
+    BatchFormatterTests() = default;
+    virtual ~BatchFormatterTests() = default;
+
+    std::vector<std::string> numberedInputs(const std::size_t count) const
+    {
+        std::vector<std::string> inputs;
+        for (std::size_t i = 0; i < count; ++i) {
+            inputs.push_back("void f" + std::to_string(i) + "() {\na(); b();\n}\n");
+        }
+
+        return inputs;
+    }
+
+    static std::string expectedOutput(const std::size_t i)
+    {
+        return "void f" + std::to_string(i) + "() {\n    a();\n    b();\n}\n";
+    }
+
+    formatter::FormatterOptions options = testsOptions();
+};
+
+
+TEST_F(BatchFormatterTests, FormatBuffersInInputOrder)
+{
+    const auto inputs = numberedInputs(500);
+    const std::vector<std::string_view> input_views(inputs.cbegin(), inputs.cend());
+
+    const auto results = batch::formatBuffers(input_views, options, 4);
+
+    ASSERT_EQ(results.size(), inputs.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].status, batch::ItemResult::Status::Formatted);
+        EXPECT_EQ(results[i].output, expectedOutput(i));
+        EXPECT_EQ(results[i].statistics.lines, 3u);
+    }
+}
+
+TEST_F(BatchFormatterTests, KeepTextFormatOfEveryBuffer)
+{
+    const std::vector<std::string_view> inputs {
+        "\xEF\xBB\xBF{\r\na();\r\n}",
+        "{\ra();\r}\r",
+        "",
+    };
+
+    const auto results = batch::formatBuffers(inputs, options, 2);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].output, "\xEF\xBB\xBF{\r\n    a();\r\n}");
+    EXPECT_EQ(results[1].output, "{\r    a();\r}\r");
+    EXPECT_EQ(results[2].output, "");
+}
+
+TEST_F(BatchFormatterTests, ReportInvalidInputPerItem)
+{
+    const std::vector<std::string_view> inputs {
+        "{\na();\n}\n",
+        "a();\n\xFF\n",
+        "b();\n",
+    };
+
+    const auto results = batch::formatBuffers(inputs, options, 3);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].status, batch::ItemResult::Status::Formatted);
+    EXPECT_EQ(results[1].status, batch::ItemResult::Status::InvalidInput);
+    EXPECT_TRUE(results[1].output.empty());
+    EXPECT_FALSE(results[1].error.empty());
+    EXPECT_EQ(results[2].status, batch::ItemResult::Status::Formatted);
+    EXPECT_EQ(results[2].output, "b();\n");
+}
+
+TEST_F(BatchFormatterTests, PassThroughItemOverLimits)
+{
+    const std::vector<std::string_view> inputs {
+        "{\na(); b();\n}\n",
+        "{\r\n{\r\n{\r\na();\r\n}\r\n}\r\n}\r\n",
+    };
+    options.limits.indentation_depth = 2;
+
+    const auto results = batch::formatBuffers(inputs, options, 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].status, batch::ItemResult::Status::Formatted);
+    EXPECT_EQ(results[0].output, "{\n    a();\n    b();\n}\n");
+    EXPECT_EQ(results[1].status, batch::ItemResult::Status::BudgetExceeded);
+    EXPECT_EQ(results[1].output, inputs[1]);
+    EXPECT_FALSE(results[1].error.empty());
+}
+
+TEST_F(BatchFormatterTests, IndentOnKeywordsInEveryItem)
+{
+    const std::vector<std::string_view> inputs {
+        "begin\na();\nend\n",
+        "x();\nbegin\nbegin\ny();\nend\nend\n",
+    };
+    options.indentation.increase_indentation_keywords = {"begin"};
+    options.indentation.decrease_indentation_keywords = {"end"};
+
+    const auto results = batch::formatBuffers(inputs, options, 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].output, "begin\n    a();\nend\n");
+    EXPECT_EQ(results[1].output, "x();\nbegin\n    begin\n        y();\n    end\nend\n");
+}
+
+TEST_F(BatchFormatterTests, UseCallerProvidedExecutor)
+{
+    const auto inputs = numberedInputs(10);
+    const std::vector<std::string_view> input_views(inputs.cbegin(), inputs.cend());
+    CountingExecutor executor;
+
+    const auto results = batch::formatBuffers(input_views, options, executor);
+
+    EXPECT_EQ(executor.submitted_tasks, 4u);
+    ASSERT_EQ(results.size(), inputs.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].output, expectedOutput(i));
+    }
+}
+
+TEST_F(BatchFormatterTests, FormatOnCallingThreadWhenExecutorFails)
+{
+    const auto inputs = numberedInputs(10);
+    const std::vector<std::string_view> input_views(inputs.cbegin(), inputs.cend());
+    FailingExecutor executor;
+
+    const auto results = batch::formatBuffers(input_views, options, executor);
+
+    ASSERT_EQ(results.size(), inputs.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i].output, expectedOutput(i));
+    }
+}
+
+TEST_F(BatchFormatterTests, RunNestedBatchesOnTheSameThreadPool)
+{
+    const auto inputs = numberedInputs(20);
+    const std::vector<std::string_view> input_views(inputs.cbegin(), inputs.cend());
+    batch::ThreadPool thread_pool(2);
+
+    std::vector<std::vector<batch::ItemResult>> nested_results(4);
+    std::atomic<int> finished_batches {0};
+    for (auto &results : nested_results) {
+        thread_pool.submit([&] {
+            results = batch::formatBuffers(input_views, options, thread_pool);
+            ++finished_batches;
+        });
+    }
+    while (finished_batches < 4) {
+        std::this_thread::yield();
+    }
+
+    for (const auto &results : nested_results) {
+        ASSERT_EQ(results.size(), inputs.size());
+        EXPECT_EQ(results.back().output, expectedOutput(inputs.size() - 1));
+    }
+}
+
+TEST_F(BatchFormatterTests, HandleEmptyBatch)
+{
+    EXPECT_TRUE(batch::formatBuffers({}, options).empty());
+}
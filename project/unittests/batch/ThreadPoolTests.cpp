@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <batch/ThreadPool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+
+struct ThreadPoolTests : ::testing::Test
+{
+    ThreadPoolTests() = default;
+    virtual ~ThreadPoolTests() = default;
+};
+
+
+TEST_F(ThreadPoolTests, ReportNumberOfThreads)
+{
+    batch::ThreadPool thread_pool(3);
+
+    EXPECT_EQ(thread_pool.concurrency(), 3u);
+}
+
+TEST_F(ThreadPoolTests, UseHardwareThreadsByDefault)
+{
+    batch::ThreadPool thread_pool;
+
+    EXPECT_GE(thread_pool.concurrency(), 1u);
+}
+
+TEST_F(ThreadPoolTests, RunQueuedTasksBeforeDestruction)
+{
+    std::atomic<int> executed_tasks {0};
+    std::mutex mutex;
+    std::set<std::thread::id> thread_ids;
+
+    {
+        batch::ThreadPool thread_pool(2);
+        for (int i = 0; i < 1000; ++i) {
+            thread_pool.submit([&] {
+                ++executed_tasks;
+                std::lock_guard<std::mutex> lock(mutex);
+                thread_ids.insert(std::this_thread::get_id());
+            });
+        }
+    }
+
+    EXPECT_EQ(executed_tasks, 1000);
+    EXPECT_LE(thread_ids.size(), 2u);
+    EXPECT_EQ(thread_ids.count(std::this_thread::get_id()), 0u);
+}
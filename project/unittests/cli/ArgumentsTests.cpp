@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cli/Arguments.hpp>
+
+#include <gtest/gtest.h>
+
+
+struct ArgumentsTests : ::testing::Test
+{
+    ArgumentsTests() = default;
+    virtual ~ArgumentsTests() = default;
+};
+
+
+TEST_F(ArgumentsTests, ParseInputFiles)
+{
+    const char *argv[] = {"code-formatter", "a.c", "b.c"};
+
+    const auto arguments = cli::parseArguments(3, argv);
+
+    EXPECT_EQ(arguments.files, (std::vector<std::string>{"a.c", "b.c"}));
+    EXPECT_FALSE(arguments.in_place);
+    EXPECT_FALSE(arguments.git_base);
+}
+
+TEST_F(ArgumentsTests, ParseInPlaceFlag)
+{
+    const char *argv[] = {"code-formatter", "-i", "a.c"};
+
+    const auto arguments = cli::parseArguments(3, argv);
+
+    EXPECT_TRUE(arguments.in_place);
+}
+
+TEST_F(ArgumentsTests, ParseGitBaseWithSeparateAndInlineValue)
+{
+    const char *separate_argv[] = {"code-formatter", "--git-base", "HEAD~1"};
+    const char *inline_argv[] = {"code-formatter", "--git-base=main"};
+
+    EXPECT_EQ(cli::parseArguments(3, separate_argv).git_base, "HEAD~1");
+    EXPECT_EQ(cli::parseArguments(2, inline_argv).git_base, "main");
+}
+
+TEST_F(ArgumentsTests, ThrowOnUnknownOption)
+{
+    const char *argv[] = {"code-formatter", "--unknown", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(3, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenNoInputFiles)
+{
+    const char *argv[] = {"code-formatter"};
+
+    EXPECT_THROW(cli::parseArguments(1, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenDiffIsUsedWithInPlace)
+{
+    const char *argv[] = {"code-formatter", "--diff", "-i", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(4, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenPipelineIsUsedWithDiff)
+{
+    const char *argv[] = {"code-formatter", "--pipeline", "--diff", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(4, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenMappedOutputIsNotWrittenInPlace)
+{
+    const char *argv[] = {"code-formatter", "--mapped-output", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(3, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ParseTraceFile)
+{
+    const char *argv[] = {"code-formatter", "--trace=trace.json", "a.c"};
+
+    EXPECT_EQ(cli::parseArguments(3, argv).trace_file, "trace.json");
+}
+
+TEST_F(ArgumentsTests, ThrowWhenTraceIsUsedWithWatch)
+{
+    const char *argv[] = {"code-formatter", "--trace", "trace.json", "--watch", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(5, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenEditsAreUsedWithInPlace)
+{
+    const char *argv[] = {"code-formatter", "--edits", "-i", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(4, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ParseLspWithoutInputFiles)
+{
+    const char *argv[] = {"code-formatter", "--lsp"};
+
+    EXPECT_TRUE(cli::parseArguments(2, argv).lsp);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenLspIsUsedWithInputFiles)
+{
+    const char *argv[] = {"code-formatter", "--lsp", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(3, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ParseLimits)
+{
+    const char *argv[] = {"code-formatter", "--max-time=100", "--max-bytes", "4096",
+                          "--max-lines=50", "--max-depth=8", "a.c"};
+
+    const auto arguments = cli::parseArguments(7, argv);
+
+    EXPECT_EQ(arguments.max_time_ms, 100u);
+    EXPECT_EQ(arguments.max_bytes, 4096u);
+    EXPECT_EQ(arguments.max_lines, 50u);
+    EXPECT_EQ(arguments.max_depth, 8u);
+}
+
+TEST_F(ArgumentsTests, ThrowWhenLimitIsNotNumber)
+{
+    const char *argv[] = {"code-formatter", "--max-lines=many", "a.c"};
+
+    EXPECT_THROW(cli::parseArguments(3, argv), cli::InvalidArgumentError);
+}
+
+TEST_F(ArgumentsTests, ParseShortOptionWithAttachedValue)
+{
+    const char *argv[] = {"code-formatter", "-j4", "a.c"};
+
+    EXPECT_EQ(cli::parseArguments(3, argv).jobs, 4u);
+}
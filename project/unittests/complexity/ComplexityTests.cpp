@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <diff/UnifiedDiff.hpp>
+#include <formatter/FormattedLines.hpp>
+#include <formatter/Formatter.hpp>
+#include <formatter/IncrementalFormatter.hpp>
+#include <formatter/TextEdits.hpp>
+#include <formatter/detail/InsertNewLineAfterChar.hpp>
+#include <formatter/detail/OperationCounter.hpp>
+#include <formatter/detail/UpdateIndentation.hpp>
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+#include <io/InputNormalizer.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <sstream>
+#include <string>
+
+
+/*
+ * Every pass runs over inputs of doubling size. The allocations and the
+ * allocated bytes are measured instead of time, so the results are the
+ * same on every run. Divided by the number of processed bytes they stay
+ * flat for linear passes and grow with the input otherwise. Only the line
+ * splitting and the indentation count their operations too, for the
+ * other passes the operations stay zero.
+ */
+
+namespace
+{
+
+std::atomic<std::size_t> allocations {0};
+std::atomic<std::size_t> allocated_bytes {0};
+
+}
+
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    allocated_bytes += size;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++allocations;
+    allocated_bytes += size;
+    const auto alignment_value = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    void *p = nullptr;
+    if (posix_memalign(&p, alignment_value, size == 0 ? 1 : size) == 0) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+
+namespace
+{
+
+struct Cost
+{
+    std::size_t allocations {0};
+    std::size_t allocated_bytes {0};
+    std::size_t operations {0};
+    std::size_t processed_bytes {0};
+};
+
+
+template <typename Pass>
+Cost
+measure(const std::size_t processed_bytes, Pass pass)
+{
+    const auto allocations_before = allocations.load();
+    const auto allocated_bytes_before = allocated_bytes.load();
+    const auto operations_before = formatter::detail::counted_operations;
+
+    pass();
+
+    return Cost{allocations.load() - allocations_before,
+                allocated_bytes.load() - allocated_bytes_before,
+                formatter::detail::counted_operations - operations_before,
+                processed_bytes};
+}
+
+
+std::size_t
+contentSize(const FileContent &content)
+{
+    std::size_t size = 0;
+    for (const auto &line : content) {
+        size += line.size() + 1;
+    }
+
+    return size;
+}
+
+
+FileContent
+toContent(const std::string &text)
+{
+    return io::splitLines(text);
+}
+
+
+std::string
+longLine(const std::size_t statements)
+{
+    std::string text;
+    for (std::size_t i = 0; i < statements; ++i) {
+        text += "call(argument); ";
+    }
+
+    return text + "\n";
+}
+
+
+std::string
+deepNesting(const std::size_t depth)
+{
+    std::string text;
+    for (std::size_t i = 0; i < depth; ++i) {
+        text += "if (condition) {\n";
+    }
+    for (std::size_t i = 0; i < depth; ++i) {
+        text += "}\n";
+    }
+
+    return text;
+}
+
+
+std::string
+manyDelimiters(const std::size_t delimiters)
+{
+    return std::string(delimiters, ';') + "{{{" + std::string(delimiters, '}') + ";x\n";
+}
+
+
+std::string
+shortLines(const std::size_t lines)
+{
+    std::string text;
+    for (std::size_t i = 0; i < lines; ++i) {
+        text += i % 3 == 0 ? "{\r\n" : i % 3 == 1 ? "x;y\r\n" : "}\r\n";
+    }
+
+    return text;
+}
+
+
+struct Shape
+{
+    const char *name;
+    std::function<std::string(std::size_t)> generate;
+    std::size_t base_size;
+};
+
+
+const Shape shapes[] = {
+    {"long line", longLine, 2000},
+    {"deep nesting", deepNesting, 250},
+    {"many delimiters", manyDelimiters, 2000},
+    {"short lines", shortLines, 4000},
+};
+
+}
+
+
+struct ComplexityTests : ::testing::Test
+{
+    ComplexityTests() = default;
+    virtual ~ComplexityTests() = default;
+
+    static constexpr int doublings = 3;
+
+    /*
+     * Allows the cost per processed byte to grow by half between the
+     * smallest and the largest input, a quadratic pass grows eightfold.
+     */
+    static void expectLinearGrowth(const std::function<Cost(const std::string &input)> &run_pass)
+    {
+        for (const auto &shape : shapes) {
+            const auto first_cost = run_pass(shape.generate(shape.base_size));
+            const auto last_cost = run_pass(shape.generate(shape.base_size << doublings));
+
+            const auto per_byte = [](const std::size_t value, const Cost &cost) {
+                return static_cast<double>(value) / static_cast<double>(cost.processed_bytes);
+            };
+
+            EXPECT_LE(per_byte(last_cost.allocations, last_cost),
+                      1.5 * per_byte(first_cost.allocations, first_cost) + 0.001)
+                << shape.name << ": " << first_cost.allocations << " -> " << last_cost.allocations
+                << " allocations";
+            EXPECT_LE(per_byte(last_cost.allocated_bytes, last_cost),
+                      1.5 * per_byte(first_cost.allocated_bytes, first_cost) + 0.1)
+                << shape.name << ": " << first_cost.allocated_bytes << " -> " << last_cost.allocated_bytes
+                << " allocated bytes";
+            EXPECT_LE(per_byte(last_cost.operations, last_cost),
+                      1.5 * per_byte(first_cost.operations, first_cost) + 0.1)
+                << shape.name << ": " << first_cost.operations << " -> " << last_cost.operations
+                << " operations";
+        }
+    }
+};
+
+
+TEST_F(ComplexityTests, NormalizeInput)
+{
+    expectLinearGrowth([](const std::string &input) {
+        return measure(input.size(), [&] { io::normalizeInput(input); });
+    });
+}
+
+TEST_F(ComplexityTests, SplitLines)
+{
+    expectLinearGrowth([](const std::string &input) {
+        return measure(input.size(), [&] { io::splitLines(input); });
+    });
+}
+
+TEST_F(ComplexityTests, InsertNewLineAfterChar)
+{
+    expectLinearGrowth([](const std::string &input) {
+        auto content = toContent(input);
+        return measure(input.size(), [&] {
+            formatter::detail::insertNewLineAfterChar(content, ';');
+        });
+    });
+}
+
+TEST_F(ComplexityTests, UpdateIndentation)
+{
+    const auto options = testsOptions();
+
+    expectLinearGrowth([&](const std::string &input) {
+        auto content = toContent(input);
+        formatter::detail::insertNewLineAfterChar(content, ';');
+        const auto cost = measure(0, [&] {
+            formatter::detail::updateIndentation(content, options.indentation);
+        });
+        return Cost{cost.allocations, cost.allocated_bytes, cost.operations, input.size() + contentSize(content)};
+    });
+}
+
+/*
+ * The inserted indentation grows with the depth, so it hides a pass
+ * walking the whole nesting for every line. Without it only the tracking
+ * of the nesting is left.
+ */
+TEST_F(ComplexityTests, TrackIndentationDepth)
+{
+    auto options = testsOptions();
+    options.indentation.num_of_spaces = 0;
+
+    expectLinearGrowth([&](const std::string &input) {
+        auto content = toContent(input);
+        return measure(input.size(), [&] {
+            formatter::detail::updateIndentation(content, options.indentation);
+        });
+    });
+}
+
+TEST_F(ComplexityTests, Format)
+{
+    const auto options = testsOptions();
+
+    expectLinearGrowth([&](const std::string &input) {
+        auto content = toContent(input);
+        const auto cost = measure(0, [&] { formatter::format(content, options); });
+        return Cost{cost.allocations, cost.allocated_bytes, cost.operations, input.size() + contentSize(content)};
+    });
+}
+
+TEST_F(ComplexityTests, FirstFormattedLine)
+{
+    const auto options = testsOptions();
+    const auto first_line_cost = [&options](const std::string &input) {
+        return measure(input.size(), [&] {
+            formatter::FormattedLines lines(input, options);
+            lines.begin();
+        });
+    };
+
+    for (const auto &shape : {deepNesting, shortLines}) {
+        const auto first_cost = first_line_cost(shape(1000));
+        const auto last_cost = first_line_cost(shape(1000 << doublings));
+
+        EXPECT_EQ(first_cost.allocations, last_cost.allocations);
+        EXPECT_EQ(first_cost.allocated_bytes, last_cost.allocated_bytes);
+        EXPECT_EQ(first_cost.operations, last_cost.operations);
+    }
+}
+
+TEST_F(ComplexityTests, FormatSelectedLines)
+{
+    const auto options = testsOptions();
+
+    expectLinearGrowth([&](const std::string &input) {
+        auto content = toContent(input);
+        const std::vector<LineRange> line_ranges {{1, content.size() / 2}};
+        const auto cost = measure(0, [&] { formatter::format(content, options, line_ranges); });
+        return Cost{cost.allocations, cost.allocated_bytes, cost.operations, input.size() + contentSize(content)};
+    });
+}
+
+TEST_F(ComplexityTests, IncrementalFormat)
+{
+    const auto options = testsOptions();
+
+    expectLinearGrowth([&](const std::string &input) {
+        const auto content = toContent(input);
+        formatter::IncrementalFormatter incremental_formatter(options);
+        FileContent output;
+        const auto cost = measure(0, [&] { output = incremental_formatter.format(content); });
+        return Cost{cost.allocations, cost.allocated_bytes, cost.operations, input.size() + contentSize(output)};
+    });
+}
+
+TEST_F(ComplexityTests, FormatEdits)
+{
+    const auto options = testsOptions();
+
+    expectLinearGrowth([&](const std::string &input) {
+        std::vector<formatter::TextEdit> edits;
+        const auto cost = measure(0, [&] { edits = formatter::formatEdits(input, options); });
+
+        std::size_t replacement_bytes = 0;
+        for (const auto &edit : edits) {
+            replacement_bytes += edit.replacement.size();
+        }
+        return Cost{cost.allocations, cost.allocated_bytes, cost.operations, input.size() + replacement_bytes};
+    });
+}
+
+TEST_F(ComplexityTests, WriteContent)
+{
+    expectLinearGrowth([](const std::string &input) {
+        const auto content = toContent(input);
+        std::ostringstream output;
+        return measure(input.size(), [&] { io::writeContent(output, content, io::TextFormat{}); });
+    });
+}
+
+TEST_F(ComplexityTests, UnifiedDiff)
+{
+    const auto options = testsOptions();
+
+    expectLinearGrowth([&](const std::string &input) {
+        const auto original = toContent(input);
+        auto formatted = original;
+        formatter::format(formatted, options);
+        return measure(input.size() + contentSize(formatted), [&] {
+            diff::unifiedDiff(original, formatted, io::TextFormat{}, "a", "b");
+        });
+    });
+}
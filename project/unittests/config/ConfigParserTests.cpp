@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <config/ConfigParser.hpp>
+
+#include <gtest/gtest.h>
+
+
+struct ConfigParserTests : ::testing::Test
+{
+    ConfigParserTests() = default;
+    virtual ~ConfigParserTests() = default;
+};
+
+
+TEST_F(ConfigParserTests, ParseAllOptions)
+{
+    formatter::FormatterOptions options;
+
+    const auto parsed = config::parseConfig(
+        "# indentation\n"
+        "increase_indentation_chars = { (\n"
+        "decrease_indentation_chars = } )\n"
+        "num_of_spaces = 2\n"
+        "reduce_indent_for_last_decrease_char = true\n"
+        "progressive_indent = true\n"
+        "root = true\n",
+        options);
+
+    EXPECT_EQ(options.indentation.increase_indentation_chars, (std::set<char>{'{', '('}));
+    EXPECT_EQ(options.indentation.decrease_indentation_chars, (std::set<char>{'}', ')'}));
+    EXPECT_EQ(options.indentation.num_of_spaces, 2);
+    EXPECT_TRUE(options.indentation.reduce_indent_for_last_decrease_char);
+    EXPECT_TRUE(options.indentation.progressive_indent);
+    EXPECT_TRUE(parsed.is_root);
+}
+
+TEST_F(ConfigParserTests, ParseSplitOptions)
+{
+    formatter::FormatterOptions options;
+
+    config::parseConfig(
+        "split_after_chars = ; ,\n"
+        "split_before_chars = {\n"
+        "keep_trailing_delimiter = false\n"
+        "keep_delimiter_runs = true\n",
+        options);
+
+    EXPECT_EQ(options.split.split_after_chars, (std::set<char>{';', ','}));
+    EXPECT_EQ(options.split.split_before_chars, (std::set<char>{'{'}));
+    EXPECT_FALSE(options.split.keep_trailing_delimiter);
+    EXPECT_TRUE(options.split.keep_delimiter_runs);
+}
+
+TEST_F(ConfigParserTests, ParseKeywords)
+{
+    formatter::FormatterOptions options;
+
+    config::parseConfig(
+        "increase_indentation_keywords = begin  do\tthen\n"
+        "decrease_indentation_keywords = end done #endif\n",
+        options);
+
+    EXPECT_EQ(options.indentation.increase_indentation_keywords, (std::vector<std::string>{"begin", "do", "then"}));
+    EXPECT_EQ(options.indentation.decrease_indentation_keywords, (std::vector<std::string>{"end", "done", "#endif"}));
+}
+
+TEST_F(ConfigParserTests, KeepOptionsNotMentionedInConfig)
+{
+    formatter::FormatterOptions options;
+    options.indentation.num_of_spaces = 4;
+    options.indentation.increase_indentation_chars = {'{'};
+
+    config::parseConfig("num_of_spaces = 8\r\n", options);
+
+    EXPECT_EQ(options.indentation.num_of_spaces, 8);
+    EXPECT_EQ(options.indentation.increase_indentation_chars, (std::set<char>{'{'}));
+}
+
+TEST_F(ConfigParserTests, ThrowOnUnknownOptionWithLineNumber)
+{
+    formatter::FormatterOptions options;
+
+    try {
+        config::parseConfig("num_of_spaces = 2\nunknown = 1\n", options);
+        FAIL() << "exception not thrown";
+    }
+    catch (const config::ConfigError &e) {
+        EXPECT_STREQ(e.what(), "line 2: unknown option: unknown");
+    }
+}
+
+TEST_F(ConfigParserTests, ThrowOnInvalidValues)
+{
+    formatter::FormatterOptions options;
+
+    EXPECT_THROW(config::parseConfig("num_of_spaces = four\n", options), config::ConfigError);
+    EXPECT_THROW(config::parseConfig("progressive_indent = yes\n", options), config::ConfigError);
+    EXPECT_THROW(config::parseConfig("progressive_indent\n", options), config::ConfigError);
+}
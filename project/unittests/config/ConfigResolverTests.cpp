@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <config/ConfigResolver.hpp>
+#include <config/ConfigParser.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+namespace
+{
+
+class FakeFileSystem : public config::FileSystem
+{
+public:
+    std::optional<std::string> readFile(const std::filesystem::path &path) override
+    {
+        if (on_read) {
+            on_read(path.string());
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++lookups[path.string()];
+
+        const auto file_it = files.find(path.string());
+        if (file_it == files.end()) {
+            return std::nullopt;
+        }
+        return file_it->second;
+    }
+
+    int totalLookups() const
+    {
+        int total = 0;
+        for (const auto &[path, count] : lookups) {
+            total += count;
+        }
+        return total;
+    }
+
+    std::map<std::string, std::string> files;
+    std::map<std::string, int> lookups;
+    std::function<void(const std::string &path)> on_read;
+    std::mutex mutex;
+};
+
+}
+
+
+struct ConfigResolverTests : ::testing::Test
+{
+    ConfigResolverTests() = default;
+    virtual ~ConfigResolverTests() = default;
+
+    FakeFileSystem file_system;
+};
+
+
+TEST_F(ConfigResolverTests, UseDefaultsWithoutConfigFiles)
+{
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    const auto options = resolver.optionsForFile("/project/src/a.c");
+
+    EXPECT_EQ(options->indentation.num_of_spaces, 4);
+    EXPECT_EQ(file_system.totalLookups(), 3);
+}
+
+TEST_F(ConfigResolverTests, NearestConfigWinsAndInheritsParents)
+{
+    file_system.files["/project/.code-formatter"] = "num_of_spaces = 2\nprogressive_indent = true\n";
+    file_system.files["/project/src/.code-formatter"] = "num_of_spaces = 8\n";
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    const auto project_options = resolver.optionsForFile("/project/a.c");
+    const auto src_options = resolver.optionsForFile("/project/src/a.c");
+
+    EXPECT_EQ(project_options->indentation.num_of_spaces, 2);
+    EXPECT_EQ(src_options->indentation.num_of_spaces, 8);
+    EXPECT_TRUE(src_options->indentation.progressive_indent);
+    EXPECT_EQ(src_options->indentation.increase_indentation_chars, (std::set<char>{'{', '('}));
+}
+
+TEST_F(ConfigResolverTests, RootConfigStopsInheritance)
+{
+    file_system.files["/project/.code-formatter"] = "progressive_indent = true\n";
+    file_system.files["/project/lib/.code-formatter"] = "root = true\nnum_of_spaces = 2\n";
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    const auto options = resolver.optionsForFile("/project/lib/a.c");
+
+    EXPECT_EQ(options->indentation.num_of_spaces, 2);
+    EXPECT_FALSE(options->indentation.progressive_indent);
+}
+
+TEST_F(ConfigResolverTests, ReadEachConfigFileOnceForManyFiles)
+{
+    file_system.files["/project/.code-formatter"] = "num_of_spaces = 2\n";
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    for (int i = 0; i < 100; ++i) {
+        resolver.optionsForFile("/project/src/a" + std::to_string(i) + ".c");
+    }
+
+    EXPECT_EQ(file_system.lookups["/project/.code-formatter"], 1);
+    EXPECT_EQ(file_system.totalLookups(), 3);
+}
+
+TEST_F(ConfigResolverTests, DoNotLookAtCachedParentsForSiblingDirectories)
+{
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    resolver.optionsForFile("/project/src/a/x.c");
+    const auto lookups_after_first_file = file_system.totalLookups();
+    resolver.optionsForFile("/project/src/b/x.c");
+
+    EXPECT_EQ(lookups_after_first_file, 4);
+    EXPECT_EQ(file_system.totalLookups(), lookups_after_first_file + 1);
+}
+
+TEST_F(ConfigResolverTests, ShareResolvedOptionsBetweenFilesOfDirectory)
+{
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    const auto first = resolver.optionsForFile("/project/a.c");
+    const auto second = resolver.optionsForFile("/project/./b.c");
+    const auto directory = resolver.optionsForDirectory("/project/");
+
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(first.get(), directory.get());
+}
+
+TEST_F(ConfigResolverTests, CompileKeywordsOncePerConfigFile)
+{
+    file_system.files["/project/.code-formatter"] = "increase_indentation_keywords = begin\n"
+                                                    "decrease_indentation_keywords = end\n";
+    file_system.files["/project/lib/.code-formatter"] = "root = true\n";
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    const auto first = resolver.resolveFile("/project/a.c");
+    const auto second = resolver.resolveFile("/project/b.c");
+    const auto nested = resolver.resolveFile("/project/src/a.c");
+    const auto without_keywords = resolver.resolveFile("/project/lib/a.c");
+
+    ASSERT_NE(first.keyword_matcher, nullptr);
+    EXPECT_EQ(first.keyword_matcher.get(), second.keyword_matcher.get());
+    EXPECT_EQ(first.keyword_matcher.get(), nested.keyword_matcher.get());
+    EXPECT_EQ(without_keywords.keyword_matcher, nullptr);
+}
+
+TEST_F(ConfigResolverTests, ReportConfigPathOnError)
+{
+    file_system.files["/project/.code-formatter"] = "unknown = 1\n";
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    try {
+        resolver.optionsForFile("/project/a.c");
+        FAIL() << "exception not thrown";
+    }
+    catch (const config::ConfigError &e) {
+        EXPECT_STREQ(e.what(), "/project/.code-formatter: line 1: unknown option: unknown");
+    }
+}
+
+TEST_F(ConfigResolverTests, ResolveFromManyThreads)
+{
+    file_system.files["/project/.code-formatter"] = "num_of_spaces = 2\n";
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&resolver, t] {
+            for (int i = 0; i < 50; ++i) {
+                const auto options = resolver.optionsForFile(
+                    "/project/d" + std::to_string(i % 10) + "/f" + std::to_string(t) + ".c");
+                EXPECT_EQ(options->indentation.num_of_spaces, 2);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    /*
+     * The threads starting together may all read the shared config.
+     */
+    EXPECT_GE(file_system.lookups["/project/.code-formatter"], 1);
+    EXPECT_LE(file_system.lookups["/project/.code-formatter"], 4);
+}
+
+TEST_F(ConfigResolverTests, ResolveOtherDirectoriesWhileReadingConfig)
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool slow_reading = false;
+    bool other_resolved = false;
+    bool resolved_while_reading = false;
+    file_system.on_read = [&](const std::string &path) {
+        if (path == "/slow/.code-formatter") {
+            std::unique_lock<std::mutex> lock(mutex);
+            slow_reading = true;
+            condition.notify_all();
+            resolved_while_reading = condition.wait_for(lock, std::chrono::seconds(5), [&] {
+                return other_resolved;
+            });
+        }
+    };
+    config::ConfigResolver resolver(testsOptions(), file_system);
+
+    std::thread slow_thread([&resolver] {
+        resolver.optionsForFile("/slow/a.c");
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return slow_reading; });
+    }
+    resolver.optionsForFile("/fast/b.c");
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        other_resolved = true;
+    }
+    condition.notify_all();
+    slow_thread.join();
+
+    EXPECT_TRUE(resolved_while_reading);
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <diff/LineDiff.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+
+struct LineDiffTests : ::testing::Test
+{
+    LineDiffTests() = default;
+    virtual ~LineDiffTests() = default;
+
+    static std::size_t countChanges(const diff::LineDiff &line_diff)
+    {
+        return std::count(line_diff.removed.cbegin(), line_diff.removed.cend(), true)
+            + std::count(line_diff.added.cbegin(), line_diff.added.cend(), true);
+    }
+
+    static std::size_t longestCommonSubsequence(const std::vector<std::string_view> &a,
+                                                const std::vector<std::string_view> &b)
+    {
+        std::vector<std::vector<std::size_t>> lengths(a.size() + 1, std::vector<std::size_t>(b.size() + 1, 0));
+        for (std::size_t i = 1; i <= a.size(); ++i) {
+            for (std::size_t j = 1; j <= b.size(); ++j) {
+                lengths[i][j] = a[i - 1] == b[j - 1]
+                    ? lengths[i - 1][j - 1] + 1
+                    : std::max(lengths[i - 1][j], lengths[i][j - 1]);
+            }
+        }
+
+        return lengths[a.size()][b.size()];
+    }
+
+    static bool isCommonSubsequence(const diff::LineDiff &line_diff,
+                                    const std::vector<std::string_view> &a,
+                                    const std::vector<std::string_view> &b)
+    {
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < a.size() or j < b.size()) {
+            if (i < a.size() and line_diff.removed[i]) {
+                ++i;
+            }
+            else if (j < b.size() and line_diff.added[j]) {
+                ++j;
+            }
+            else if (i < a.size() and j < b.size() and a[i] == b[j]) {
+                ++i;
+                ++j;
+            }
+            else {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+
+TEST_F(LineDiffTests, ReportNoChangesForEqualLines)
+{
+    const std::vector<std::string_view> lines {"a", "b", "c"};
+
+    const auto line_diff = diff::diffLines(lines, lines);
+
+    EXPECT_EQ(countChanges(line_diff), 0u);
+}
+
+TEST_F(LineDiffTests, ReportChangedLine)
+{
+    const std::vector<std::string_view> original {"a", "b", "c"};
+    const std::vector<std::string_view> modified {"a", "B", "c"};
+
+    const auto line_diff = diff::diffLines(original, modified);
+
+    EXPECT_EQ(line_diff.removed, (std::vector<bool>{false, true, false}));
+    EXPECT_EQ(line_diff.added, (std::vector<bool>{false, true, false}));
+}
+
+TEST_F(LineDiffTests, ReportLinesOnlyInOneSide)
+{
+    const std::vector<std::string_view> original {};
+    const std::vector<std::string_view> modified {"a", "b"};
+
+    const auto line_diff = diff::diffLines(original, modified);
+
+    EXPECT_TRUE(line_diff.removed.empty());
+    EXPECT_EQ(line_diff.added, (std::vector<bool>{true, true}));
+}
+
+TEST_F(LineDiffTests, FindMinimalDiffOfRandomLines)
+{
+    std::mt19937 generator(32);
+    std::uniform_int_distribution<int> line_distribution(0, 3);
+    std::uniform_int_distribution<std::size_t> size_distribution(0, 40);
+    const std::vector<std::string> alphabet {"a", "b", "c", "d"};
+
+    for (int iteration = 0; iteration < 500; ++iteration) {
+        std::vector<std::string_view> a(size_distribution(generator));
+        std::vector<std::string_view> b(size_distribution(generator));
+        for (auto &line : a) {
+            line = alphabet[line_distribution(generator)];
+        }
+        for (auto &line : b) {
+            line = alphabet[line_distribution(generator)];
+        }
+
+        const auto line_diff = diff::diffLines(a, b);
+
+        ASSERT_TRUE(isCommonSubsequence(line_diff, a, b));
+        ASSERT_EQ(countChanges(line_diff), a.size() + b.size() - 2 * longestCommonSubsequence(a, b));
+    }
+}
+
+TEST_F(LineDiffTests, ReturnValidDiffWhenCostLimitIsReached)
+{
+    std::mt19937 generator(32);
+    std::uniform_int_distribution<int> line_distribution(0, 1);
+    const std::vector<std::string> alphabet {"{", "}"};
+
+    std::vector<std::string_view> a(20000);
+    std::vector<std::string_view> b(20000);
+    for (auto &line : a) {
+        line = alphabet[line_distribution(generator)];
+    }
+    for (auto &line : b) {
+        line = alphabet[line_distribution(generator)];
+    }
+
+    const auto line_diff = diff::diffLines(a, b);
+
+    EXPECT_TRUE(isCommonSubsequence(line_diff, a, b));
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <diff/UnifiedDiff.hpp>
+#include <io/FileWriter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+
+struct UnifiedDiffTests : ::testing::Test
+{
+    UnifiedDiffTests() = default;
+    virtual ~UnifiedDiffTests() = default;
+};
+
+
+TEST_F(UnifiedDiffTests, ReturnEmptyDiffForEqualContent)
+{
+    const FileContent content {"a", "b"};
+
+    EXPECT_EQ(diff::unifiedDiff(content, content, io::TextFormat{}, "a.c", "a.c"), "");
+}
+
+TEST_F(UnifiedDiffTests, WriteHunkWithContext)
+{
+    const FileContent original {"1", "2", "3", "4", "5", "6", "7", "8", "9"};
+    const FileContent formatted {"1", "2", "3", "4", "five", "6", "7", "8", "9"};
+
+    const auto diff = diff::unifiedDiff(original, formatted, io::TextFormat{}, "a.c", "a.c");
+
+    EXPECT_EQ(diff,
+              "--- a.c\n"
+              "+++ a.c\n"
+              "@@ -2,7 +2,7 @@\n"
+              " 2\n"
+              " 3\n"
+              " 4\n"
+              "-5\n"
+              "+five\n"
+              " 6\n"
+              " 7\n"
+              " 8\n");
+}
+
+TEST_F(UnifiedDiffTests, SplitDistantChangesIntoHunks)
+{
+    const FileContent original {"a", "2", "3", "4", "5", "6", "7", "8", "9", "b"};
+    const FileContent formatted {"A", "2", "3", "4", "5", "6", "7", "8", "9", "B", "C"};
+
+    const auto diff = diff::unifiedDiff(original, formatted, io::TextFormat{}, "a.c", "a.c");
+
+    EXPECT_EQ(diff,
+              "--- a.c\n"
+              "+++ a.c\n"
+              "@@ -1,4 +1,4 @@\n"
+              "-a\n"
+              "+A\n"
+              " 2\n"
+              " 3\n"
+              " 4\n"
+              "@@ -7,4 +7,5 @@\n"
+              " 7\n"
+              " 8\n"
+              " 9\n"
+              "-b\n"
+              "+B\n"
+              "+C\n");
+}
+
+TEST_F(UnifiedDiffTests, MarkMissingNewlineAtEndOfFile)
+{
+    const FileContent original {"a", "b;c"};
+    const FileContent formatted {"a", "b;", "c"};
+    io::TextFormat format;
+    format.ends_with_newline = false;
+
+    const auto diff = diff::unifiedDiff(original, formatted, format, "a.c", "a.c");
+
+    EXPECT_EQ(diff,
+              "--- a.c\n"
+              "+++ a.c\n"
+              "@@ -1,2 +1,3 @@\n"
+              " a\n"
+              "-b;c\n"
+              "\\ No newline at end of file\n"
+              "+b;\n"
+              "+c\n"
+              "\\ No newline at end of file\n");
+}
+
+TEST_F(UnifiedDiffTests, UseZeroLineNumberWhenAddingToEmptyFile)
+{
+    const FileContent original {};
+    const FileContent formatted {"a"};
+
+    const auto diff = diff::unifiedDiff(original, formatted, io::TextFormat{}, "a.c", "a.c");
+
+    EXPECT_EQ(diff,
+              "--- a.c\n"
+              "+++ a.c\n"
+              "@@ -0,0 +1 @@\n"
+              "+a\n");
+}
+
+
+struct UnifiedDiffPatchTests : UnifiedDiffTests
+{
+    UnifiedDiffPatchTests()
+    {
+        char path_template[] = "/tmp/code-formatter-diff-XXXXXX";
+        directory = mkdtemp(path_template);
+    }
+
+    ~UnifiedDiffPatchTests() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    static std::string serialize(const FileContent &content, const io::TextFormat &format)
+    {
+        std::ostringstream output;
+        io::writeContent(output, content, format);
+        return output.str();
+    }
+
+    std::string applyPatch(const std::string &original, const std::string &diff) const
+    {
+        const auto file_path = directory + "/file.c";
+        const auto patch_path = directory + "/file.patch";
+        std::ofstream(file_path, std::ios::binary) << original;
+        std::ofstream(patch_path, std::ios::binary) << diff;
+
+        const auto command = "patch -s '" + file_path + "' '" + patch_path + "' >/dev/null 2>&1";
+        EXPECT_EQ(std::system(command.c_str()), 0) << diff;
+
+        std::ifstream input(file_path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+
+    void expectPatchApplies(const FileContent &original, const FileContent &formatted,
+                            const io::TextFormat &format) const
+    {
+        const auto diff = diff::unifiedDiff(original, formatted, format, "file.c", "file.c");
+        if (diff.empty()) {
+            return;
+        }
+
+        EXPECT_EQ(applyPatch(serialize(original, format), diff), serialize(formatted, format));
+    }
+
+    std::string directory;
+};
+
+
+TEST_F(UnifiedDiffPatchTests, ApplyDiffOfCrlfFileWithBom)
+{
+    const FileContent original {"a();b();", "if (x) {", "c();", "}"};
+    const FileContent formatted {"a();", "b();", "if (x) {", "    c();", "}"};
+    io::TextFormat format;
+    format.line_ending = io::LineEnding::CRLF;
+    format.has_bom = true;
+
+    expectPatchApplies(original, formatted, format);
+}
+
+TEST_F(UnifiedDiffPatchTests, ApplyDiffsOfRandomEdits)
+{
+    std::mt19937 generator(32);
+    std::uniform_int_distribution<int> edit_distribution(0, 9);
+
+    for (int iteration = 0; iteration < 30; ++iteration) {
+        FileContent original;
+        FileContent formatted;
+        for (int line = 0; line < 60; ++line) {
+            const auto text = "line_" + std::to_string(line) + "();";
+            original.emplace_back(text);
+
+            switch (edit_distribution(generator)) {
+                case 0:
+                    formatted.emplace_back("    " + text);
+                    break;
+                case 1:
+                    formatted.emplace_back(text);
+                    formatted.emplace_back("split();");
+                    break;
+                case 2:
+                    break;
+                default:
+                    formatted.emplace_back(text);
+            }
+        }
+
+        io::TextFormat format;
+        format.ends_with_newline = iteration % 2 == 0;
+        expectPatchApplies(original, formatted, format);
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "formatter/Budget.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+
+struct BudgetTests : ::testing::Test
+{
+    BudgetTests() = default;
+    virtual ~BudgetTests() = default;
+
+    static formatter::BudgetExceededError::Limit exceededLimit(formatter::Budget &budget,
+                                                              const std::size_t lines,
+                                                              const std::size_t line_bytes)
+    {
+        try {
+            for (std::size_t i = 0; i < lines; ++i) {
+                budget.chargeLine(line_bytes);
+            }
+        }
+        catch (const formatter::BudgetExceededError &e) {
+            return e.limit();
+        }
+
+        ADD_FAILURE() << "no limit was exceeded";
+        return formatter::BudgetExceededError::Limit::Time;
+    }
+};
+
+
+TEST_F(BudgetTests, HaveNoLimitsByDefault)
+{
+    formatter::FormatLimits limits;
+    formatter::Budget budget(limits);
+
+    EXPECT_FALSE(formatter::hasLimits(limits));
+    for (std::size_t i = 0; i < 100000; ++i) {
+        budget.chargeLine(100);
+    }
+    budget.checkIndentationDepth(100000);
+    budget.checkInputSize(1u << 30);
+}
+
+TEST_F(BudgetTests, ThrowWhenLinesLimitIsExceeded)
+{
+    formatter::FormatLimits limits;
+    limits.lines = 10;
+    formatter::Budget budget(limits);
+
+    EXPECT_EQ(exceededLimit(budget, 11, 1), formatter::BudgetExceededError::Limit::Lines);
+}
+
+TEST_F(BudgetTests, ThrowWhenBytesLimitIsExceeded)
+{
+    formatter::FormatLimits limits;
+    limits.bytes = 100;
+    formatter::Budget budget(limits);
+
+    EXPECT_EQ(exceededLimit(budget, 11, 10), formatter::BudgetExceededError::Limit::Bytes);
+    EXPECT_THROW(budget.checkInputSize(101), formatter::BudgetExceededError);
+}
+
+TEST_F(BudgetTests, ThrowWhenIndentationDepthLimitIsExceeded)
+{
+    formatter::FormatLimits limits;
+    limits.indentation_depth = 3;
+    formatter::Budget budget(limits);
+
+    budget.checkIndentationDepth(3);
+    EXPECT_THROW(budget.checkIndentationDepth(4), formatter::BudgetExceededError);
+}
+
+TEST_F(BudgetTests, ThrowWhenTimeLimitIsExceeded)
+{
+    formatter::FormatLimits limits;
+    limits.time = std::chrono::milliseconds(1);
+    formatter::Budget budget(limits);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_EQ(exceededLimit(budget, 1000, 1), formatter::BudgetExceededError::Limit::Time);
+}
+
+TEST_F(BudgetTests, CheckTimeOnLargeLine)
+{
+    formatter::FormatLimits limits;
+    limits.time = std::chrono::milliseconds(1);
+    formatter::Budget budget(limits);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_EQ(exceededLimit(budget, 1, 1 << 20), formatter::BudgetExceededError::Limit::Time);
+}
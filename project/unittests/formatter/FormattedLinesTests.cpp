@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "formatter/FormattedLines.hpp"
+#include "formatter/Formatter.hpp"
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+struct FormattedLinesTests : ::testing::Test
+{
+    FormattedLinesTests() = default;
+    virtual ~FormattedLinesTests() = default;
+
+    FileContent formatWholeText(const std::string &text) const
+    {
+        FileContent content;
+        std::size_t line_begin = 0;
+        while (line_begin < text.size()) {
+            const auto line_end = std::min(text.find('\n', line_begin), text.size());
+            content.emplace_back(text.substr(line_begin, line_end - line_begin));
+            line_begin = line_end + 1;
+        }
+
+        formatter::format(content, options);
+        return content;
+    }
+
+    formatter::FormatterOptions options = testsOptions();
+};
+
+
+TEST_F(FormattedLinesTests, GiveTheSameLinesAsFormat)
+{
+    const std::vector<std::string> texts {
+        "",
+        "\n",
+        "\n\n",
+        "a();",
+        "void f() {\nfirst_line(); second_line();\nif (x) {\ny();\n}\n}\n",
+        "void f() {\n\n    a(); b(); c();   \n}",
+    };
+
+    for (const auto &text : texts) {
+        formatter::FormattedLines lines(text, options);
+        const FileContent formatted_lines(lines.begin(), lines.end());
+
+        EXPECT_EQ(formatted_lines, formatWholeText(text)) << text;
+    }
+}
+
+TEST_F(FormattedLinesTests, GiveLinesOnDemand)
+{
+    const std::string text = "void f() {\na(); b();\n}\n";
+    formatter::FormattedLines lines(text, options);
+
+    auto line_it = lines.begin();
+    ASSERT_NE(line_it, lines.end());
+    EXPECT_EQ(*line_it, "void f() {");
+
+    ++line_it;
+    EXPECT_EQ(*line_it, "    a();");
+    EXPECT_EQ(line_it->size(), 8u);
+
+    line_it++;
+    EXPECT_EQ(*line_it, "    b();");
+
+    ++line_it;
+    EXPECT_EQ(*line_it, "}");
+
+    ++line_it;
+    EXPECT_EQ(line_it, lines.end());
+}
+
+TEST_F(FormattedLinesTests, StopWithoutAnalyzingRemainingText)
+{
+    const std::string text = "first();\n" + std::string(1000000, '{') + "\n";
+    formatter::FormattedLines lines(text, options);
+
+    const auto line_it = lines.begin();
+
+    EXPECT_EQ(*line_it, "first();");
+}
+
+TEST_F(FormattedLinesTests, ContinueFromCurrentLineOnBegin)
+{
+    const std::string text = "a();\nb();\n";
+    formatter::FormattedLines lines(text, options);
+
+    auto line_it = lines.begin();
+    ++line_it;
+
+    EXPECT_EQ(*lines.begin(), "b();");
+}
+
+TEST_F(FormattedLinesTests, CompareEqualIteratorsAtEnd)
+{
+    formatter::FormattedLines lines("", options);
+
+    EXPECT_EQ(lines.begin(), lines.end());
+    EXPECT_EQ(formatter::FormattedLines::Iterator(), lines.end());
+}
@@ -7,12 +7,212 @@
  */
 
 #include "formatter/Formatter.hpp"
+#include <TestsOptions.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 
 struct FormatterTests : ::testing::Test
 {
     FormatterTests() = default;
     virtual ~FormatterTests() = default;
 };
+
+
+TEST_F(FormatterTests, FormatWholeContent)
+{
+    FileContent content {
+        "void f() {",
+        "first_line(); second_line();",
+        "}",
+    };
+
+    formatter::format(content, testsOptions());
+
+    const FileContent expected_content {
+        "void f() {",
+        "    first_line();",
+        "    second_line();",
+        "}",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FormatterTests, SplitOnConfiguredDelimiters)
+{
+    auto options = testsOptions();
+    options.split.split_after_chars = {';', '{'};
+    options.split.split_before_chars = {'}'};
+    FileContent content {
+        "void f() { first_line(); second_line(); }",
+    };
+
+    formatter::format(content, options);
+
+    const FileContent expected_content {
+        "void f() {",
+        "    first_line();",
+        "    second_line();",
+        "}",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FormatterTests, CountUnchangedLines)
+{
+    FileContent content {
+        "void f() {",
+        "first_line(); second_line();",
+        "    third_line();",
+        "}",
+    };
+    const auto statistics = formatter::format(content, testsOptions());
+
+    EXPECT_EQ(statistics.lines, 4u);
+    EXPECT_EQ(statistics.bytes, 10u + 28u + 17u + 1u);
+    EXPECT_EQ(statistics.unchanged_lines, 3u);
+    EXPECT_EQ(statistics.unchanged_bytes, 10u + 17u + 1u);
+}
+
+TEST_F(FormatterTests, DoNotModifyLinesWhenContentIsAlreadyFormatted)
+{
+    FileContent content {
+        "void f() {",
+        "    first_line_with_a_long_name();",
+        "    if (x) {",
+        "        second_line_with_a_long_name();",
+        "    }",
+        "}",
+    };
+    const auto expected_content = content;
+    std::vector<const char*> line_data;
+    for (const auto &line : content) {
+        line_data.push_back(line.data());
+    }
+
+    formatter::format(content, testsOptions());
+
+    EXPECT_EQ(content, expected_content);
+    EXPECT_TRUE(std::equal(content.cbegin(), content.cend(), line_data.cbegin(),
+                           [](const Line &line, const char *data) { return line.data() == data; }));
+}
+
+TEST_F(FormatterTests, FormatOnlySelectedLines)
+{
+    FileContent content {
+        "void f() {",
+        "  first_line();",
+        "second_line(); third_line();",
+        "  fourth_line();",
+        "}",
+    };
+
+    formatter::format(content, testsOptions(), {{3, 3}});
+
+    const FileContent expected_content {
+        "void f() {",
+        "  first_line();",
+        "    second_line();",
+        "    third_line();",
+        "  fourth_line();",
+        "}",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FormatterTests, CarryIndentationFromUnselectedLines)
+{
+    FileContent content {
+        "void f() {",
+        "if (a) {",
+        "x(); y();",
+        "}",
+        "z();",
+        "}",
+    };
+
+    formatter::format(content, testsOptions(), {{3, 3}, {5, 6}});
+
+    const FileContent expected_content {
+        "void f() {",
+        "if (a) {",
+        "        x();",
+        "        y();",
+        "}",
+        "    z();",
+        "}",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FormatterTests, KeepContentWhenNoLinesSelected)
+{
+    FileContent content {
+        "void f() {",
+        "x(); y();",
+        "}",
+    };
+    const auto original_content = content;
+
+    formatter::format(content, testsOptions(), std::vector<LineRange>{});
+
+    EXPECT_EQ(content, original_content);
+}
+
+TEST_F(FormatterTests, ThrowWhenLinesLimitIsExceeded)
+{
+    FileContent content {
+        "void f() {",
+        "x(); y();",
+        "}",
+    };
+    auto options = testsOptions();
+    options.limits.lines = 2;
+
+    EXPECT_THROW(formatter::format(content, options), formatter::BudgetExceededError);
+}
+
+TEST_F(FormatterTests, ThrowWhenIndentationDepthLimitIsExceeded)
+{
+    FileContent content {
+        "{ ( {",
+        "x();",
+        "} ) }",
+    };
+    auto options = testsOptions();
+    options.limits.indentation_depth = 2;
+
+    try {
+        formatter::format(content, options);
+        FAIL() << "the depth limit was not checked";
+    }
+    catch (const formatter::BudgetExceededError &e) {
+        EXPECT_EQ(e.limit(), formatter::BudgetExceededError::Limit::IndentationDepth);
+    }
+}
+
+TEST_F(FormatterTests, FormatWithinLimits)
+{
+    FileContent content {
+        "void f() {",
+        "x(); y();",
+        "}",
+    };
+    auto options = testsOptions();
+    options.limits.lines = 3;
+    options.limits.indentation_depth = 1;
+    options.limits.time = std::chrono::milliseconds(60000);
+
+    formatter::format(content, options);
+
+    const FileContent expected_content {
+        "void f() {",
+        "    x();",
+        "    y();",
+        "}",
+    };
+    EXPECT_EQ(content, expected_content);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "formatter/IncrementalFormatter.hpp"
+#include "formatter/Formatter.hpp"
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string>
+
+
+namespace
+{
+
+FileContent
+generateContent(const int functions)
+{
+    FileContent content;
+    for (int i = 0; i < functions; ++i) {
+        content.emplace_back("void f" + std::to_string(i) + "() {");
+        content.push_back("first(); second();");
+        content.push_back("if (x) {");
+        content.push_back("third();");
+        content.push_back("}");
+        content.push_back("}");
+    }
+
+    return content;
+}
+
+
+FileContent
+fullFormat(FileContent content, const formatter::FormatterOptions &options)
+{
+    formatter::format(content, options);
+    return content;
+}
+
+}
+
+
+struct IncrementalFormatterTests : ::testing::Test
+{
+    IncrementalFormatterTests() = default;
+    virtual ~IncrementalFormatterTests() = default;
+
+    const formatter::FormatterOptions options = testsOptions();
+};
+
+
+TEST_F(IncrementalFormatterTests, FormatFirstVersionLikeFullFormat)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    const auto content = generateContent(10);
+
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), content.size());
+}
+
+TEST_F(IncrementalFormatterTests, FormatOnlyEditedLineWhenIndentationIsNotAffected)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    auto content = generateContent(100);
+    incremental_formatter.format(content);
+
+    *std::next(content.begin(), 301) = "changed(); call();";
+
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 1u);
+}
+
+TEST_F(IncrementalFormatterTests, FormatFollowingLinesUntilIndentationConverges)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    auto content = generateContent(100);
+    incremental_formatter.format(content);
+
+    *std::next(content.begin(), 302) = "if (x)";
+
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 4u);
+}
+
+TEST_F(IncrementalFormatterTests, HandleInsertedAndRemovedLines)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    auto content = generateContent(50);
+    incremental_formatter.format(content);
+
+    const auto inserted_it = content.insert(std::next(content.begin(), 120), {"extra(); {", "inner();", "}"});
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 3u);
+
+    content.erase(inserted_it, std::next(inserted_it, 3));
+    content.erase(std::next(content.begin(), 10));
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+}
+
+TEST_F(IncrementalFormatterTests, HandleAppendedAndTruncatedContent)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    auto content = generateContent(5);
+    incremental_formatter.format(content);
+
+    content.push_back("tail() {");
+    content.push_back("inside();");
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 2u);
+
+    content.pop_back();
+    content.push_back("again();");
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 1u);
+
+    content.resize(3);
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 0u);
+}
+
+TEST_F(IncrementalFormatterTests, DoNotFormatUnchangedContent)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    const auto content = generateContent(10);
+    const auto first_result = incremental_formatter.format(content);
+
+    EXPECT_EQ(incremental_formatter.format(content), first_result);
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 0u);
+}
+
+TEST_F(IncrementalFormatterTests, CompareWithOutputAfterAcceptingIt)
+{
+    formatter::IncrementalFormatter incremental_formatter(options);
+    auto content = incremental_formatter.format(generateContent(20));
+    incremental_formatter.acceptOutput();
+
+    *std::next(content.begin(), 50) = "edited();";
+
+    EXPECT_EQ(incremental_formatter.format(content), fullFormat(content, options));
+    EXPECT_EQ(incremental_formatter.lastFormattedLines(), 1u);
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "formatter/TextEdits.hpp"
+#include "formatter/Formatter.hpp"
+#include "io/FileWriter.hpp"
+#include "io/InputNormalizer.hpp"
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace formatter
+{
+
+void PrintTo(const TextEdit &edit, std::ostream *output)
+{
+    *output << "{" << edit.offset << ", " << edit.length << ", " << ::testing::PrintToString(edit.replacement) << "}";
+}
+
+}
+
+
+struct TextEditsTests : ::testing::Test
+{
+    TextEditsTests() = default;
+    virtual ~TextEditsTests() = default;
+
+    std::string formatWholeText(const std::string &input) const
+    {
+        const auto normalized = io::normalizeInput(input);
+        const std::string_view text = normalized.text;
+
+        FileContent content;
+        std::size_t line_begin = 0;
+        while (line_begin < text.size()) {
+            const auto line_end = std::min(text.find('\n', line_begin), text.size());
+            content.emplace_back(text.substr(line_begin, line_end - line_begin));
+            line_begin = line_end + 1;
+        }
+        formatter::format(content, options);
+
+        std::string output;
+        io::writeContent(output, content, normalized.format);
+        return output;
+    }
+
+    formatter::FormatterOptions options = testsOptions();
+};
+
+
+TEST_F(TextEditsTests, GiveTheSameTextAsFormat)
+{
+    const std::vector<std::string> inputs {
+        "",
+        "\n",
+        "a();",
+        "void f() {\nfirst_line(); second_line();\nif (x) {\ny();\n}\n}\n",
+        "void f() {\r\n\tfirst_line();   second_line();\r\n  }\r\n",
+        "void f() {\rfirst_line(); second_line();\r}",
+        "\xEF\xBB\xBFvoid f() {\na();\n}",
+        "mixed {\r\na();\nb();\rc();\r\n}\n\n",
+        "   \n\t\n{  \n  }  ",
+        "a;;b; ;  c;",
+    };
+
+    for (const auto &input : inputs) {
+        const auto edits = formatter::formatEdits(input, options);
+
+        EXPECT_EQ(formatter::applyEdits(input, edits), formatWholeText(input)) << input;
+    }
+}
+
+TEST_F(TextEditsTests, GiveTheSameTextAsFormatWithSplitOptions)
+{
+    options.split.split_after_chars = {';', '{'};
+    options.split.split_before_chars = {'}'};
+    options.split.keep_trailing_delimiter = false;
+    const std::string input = "void f() { a(); b(); }\nc(); }\n";
+
+    const auto edits = formatter::formatEdits(input, options);
+
+    EXPECT_EQ(formatter::applyEdits(input, edits), formatWholeText(input));
+}
+
+TEST_F(TextEditsTests, GiveNoEditsForFormattedText)
+{
+    const std::string input = "void f() {\n    a();\n}\n";
+
+    EXPECT_TRUE(formatter::formatEdits(input, options).empty());
+}
+
+TEST_F(TextEditsTests, InsertOnlyMissingIndentation)
+{
+    const std::string input = "void f() {\n  a();\n}\n";
+
+    const std::vector<formatter::TextEdit> expected_edits {
+        {13, 0, "  "},
+    };
+    EXPECT_EQ(formatter::formatEdits(input, options), expected_edits);
+}
+
+TEST_F(TextEditsTests, InsertLineBreakWithIndentationForSplit)
+{
+    const std::string input = "{\r\n    a(); b();\r\n}\r\n";
+
+    const std::vector<formatter::TextEdit> expected_edits {
+        {11, 0, "\r\n   "},
+    };
+    EXPECT_EQ(formatter::formatEdits(input, options), expected_edits);
+}
+
+TEST_F(TextEditsTests, ReplaceLineBreaksDifferentFromFirstOne)
+{
+    const std::string input = "a();\r\nb();\nc();\r\n";
+
+    const std::vector<formatter::TextEdit> expected_edits {
+        {10, 0, "\r"},
+    };
+    EXPECT_EQ(formatter::formatEdits(input, options), expected_edits);
+}
+
+TEST_F(TextEditsTests, ThrowOnInvalidInput)
+{
+    EXPECT_THROW(formatter::formatEdits("a();\n\xFF", options), io::InvalidInputError);
+}
@@ -114,3 +114,24 @@ TEST_F(InsertNewLineAfterCharTests, InsertNewLineAfterTargetInTheMiddleOfTheFile
     };
     EXPECT_EQ(content, expected_content);
 }
+
+TEST_F(InsertNewLineAfterCharTests, SplitSingleLineAndReturnRemainingPart)
+{
+    Line line = "first_line(); second_line(); third_line();";
+
+    const auto new_line = formatter::detail::splitLineAfterChar(line, target);
+
+    EXPECT_EQ(line, "first_line();");
+    ASSERT_TRUE(new_line);
+    EXPECT_EQ(*new_line, " second_line(); third_line();");
+}
+
+TEST_F(InsertNewLineAfterCharTests, DoNotSplitSingleLineWithTargetAsLastChar)
+{
+    Line line = "first_line();  ";
+
+    const auto new_line = formatter::detail::splitLineAfterChar(line, target);
+
+    EXPECT_EQ(line, "first_line();  ");
+    EXPECT_FALSE(new_line);
+}
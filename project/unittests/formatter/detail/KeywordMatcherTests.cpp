@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/detail/KeywordMatcher.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+
+struct KeywordMatcherTests : ::testing::Test
+{
+    KeywordMatcherTests() = default;
+    virtual ~KeywordMatcherTests() = default;
+
+    /*
+     * Lists the matched text, prefixed with '+' for increase and '-' for
+     * decrease triggers.
+     */
+    std::vector<std::string> matches(const std::string &line, const std::size_t from = 0) const
+    {
+        const formatter::detail::KeywordMatcher matcher(options);
+        std::vector<std::string> found;
+        matcher.forEachMatch(line, from, [&](const formatter::detail::KeywordMatcher::Match &match) {
+            found.push_back(std::string(match.increases ? "+" : "")
+                            + (match.decreases ? "-" : "")
+                            + line.substr(match.begin, match.end - match.begin));
+        });
+
+        return found;
+    }
+
+    formatter::IndentationOptions options;
+};
+
+
+TEST_F(KeywordMatcherTests, MatchKeywordsAtWordBoundaries)
+{
+    options.increase_indentation_keywords = {"begin", "do"};
+    options.decrease_indentation_keywords = {"end", "done"};
+
+    EXPECT_EQ(matches("begin x := 1; end"), (std::vector<std::string>{"+begin", "-end"}));
+    EXPECT_EQ(matches("legend endless done_x do_ doing"), (std::vector<std::string>{}));
+    EXPECT_EQ(matches("while x; do (done)"), (std::vector<std::string>{"+do", "-done"}));
+}
+
+TEST_F(KeywordMatcherTests, CheckBoundaryOnlyAtWordCharEnds)
+{
+    options.increase_indentation_keywords = {"#if"};
+    options.decrease_indentation_keywords = {"#endif", "end"};
+
+    EXPECT_EQ(matches("#if A"), (std::vector<std::string>{"+#if"}));
+    EXPECT_EQ(matches("#ifdef A"), (std::vector<std::string>{}));
+    EXPECT_EQ(matches("x#if y"), (std::vector<std::string>{"+#if"}));
+    EXPECT_EQ(matches("#endif"), (std::vector<std::string>{"-#endif"}));
+}
+
+TEST_F(KeywordMatcherTests, MatchCharsAnywhere)
+{
+    options.increase_indentation_chars = {'{', 'x'};
+    options.decrease_indentation_chars = {'}'};
+    options.increase_indentation_keywords = {"then"};
+
+    EXPECT_EQ(matches("axb{then}"), (std::vector<std::string>{"+x", "+{", "+then", "-}"}));
+}
+
+TEST_F(KeywordMatcherTests, PreferLongestOfMatchesEndingTogether)
+{
+    options.increase_indentation_chars = {'('};
+    options.decrease_indentation_chars = {')'};
+    options.increase_indentation_keywords = {"(*"};
+    options.decrease_indentation_keywords = {"*)"};
+
+    EXPECT_EQ(matches("x *) (y)"), (std::vector<std::string>{"-*)", "+(", "-)"}));
+}
+
+TEST_F(KeywordMatcherTests, PreferMatchEndingFirst)
+{
+    options.increase_indentation_chars = {'('};
+    options.increase_indentation_keywords = {"(*"};
+
+    EXPECT_EQ(matches("(* x"), (std::vector<std::string>{"+("}));
+}
+
+TEST_F(KeywordMatcherTests, FindKeywordsSharingSuffixes)
+{
+    options.increase_indentation_keywords = {"case", "esac_begin", "begin"};
+    options.decrease_indentation_keywords = {"gin"};
+
+    EXPECT_EQ(matches("esac_begin"), (std::vector<std::string>{"+esac_begin"}));
+    EXPECT_EQ(matches("case begin"), (std::vector<std::string>{"+case", "+begin"}));
+}
+
+TEST_F(KeywordMatcherTests, CountTriggerOfBothKindsAsBoth)
+{
+    options.increase_indentation_keywords = {"else"};
+    options.decrease_indentation_keywords = {"else"};
+
+    EXPECT_EQ(matches("else"), (std::vector<std::string>{"+-else"}));
+}
+
+TEST_F(KeywordMatcherTests, StartMatchingAtGivenPosition)
+{
+    options.increase_indentation_keywords = {"begin"};
+
+    EXPECT_EQ(matches("begin begin", 1), (std::vector<std::string>{"+begin"}));
+    EXPECT_EQ(matches("xbegin", 1), (std::vector<std::string>{}));
+}
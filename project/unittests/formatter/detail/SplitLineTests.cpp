@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <formatter/detail/SplitLine.hpp>
+
+#include <gtest/gtest.h>
+
+
+struct SplitLineTests : ::testing::Test
+{
+    SplitLineTests() = default;
+    virtual ~SplitLineTests() = default;
+
+    formatter::SplitOptions options;
+};
+
+
+TEST_F(SplitLineTests, ShouldSplitAfterEveryConfiguredChar)
+{
+    options.split_after_chars = {';', ','};
+    FileContent content {
+        "a;b,c;  d",
+        "e",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "a;",
+        "b,",
+        "c;",
+        "  d",
+        "e",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldSplitBeforeConfiguredCharAfterText)
+{
+    options.split_after_chars = {};
+    options.split_before_chars = {'{'};
+    FileContent content {
+        "  {a {b",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "  {a",
+        " {b",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldSplitBeforeAndAfterTheSameChar)
+{
+    options.split_after_chars = {','};
+    options.split_before_chars = {','};
+    FileContent content {
+        "a,b",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "a",
+        ",",
+        "b",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldKeepTrailingDelimiterByDefault)
+{
+    options.split_before_chars = {'{'};
+    FileContent content {
+        "if (a) {  ",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "if (a) {  ",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldMoveTrailingDelimiterWhenNotKept)
+{
+    options.split_before_chars = {'{'};
+    options.keep_trailing_delimiter = false;
+    FileContent content {
+        "if (a) {  ",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "if (a)",
+        " {  ",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldSplitEveryDelimiterInRun)
+{
+    options.split_before_chars = {'('};
+    FileContent content {
+        "a;;b((c",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "a;",
+        ";",
+        "b",
+        "(",
+        "(c",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldKeepDelimiterRunsTogether)
+{
+    options.split_before_chars = {'('};
+    options.keep_delimiter_runs = true;
+    FileContent content {
+        "a;;b((c",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "a;;",
+        "b",
+        "((c",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldNotSplitWithoutDelimiters)
+{
+    options.split_after_chars = {};
+    FileContent content {
+        "a;b",
+    };
+
+    formatter::detail::splitLines(content, options);
+
+    const FileContent expected_content {
+        "a;b",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(SplitLineTests, ShouldReturnNumberOfInsertedLines)
+{
+    const formatter::detail::Splitter splitter(options);
+    FileContent content {
+        "a; b; c;",
+        "d",
+    };
+
+    EXPECT_EQ(splitter.splitLine(content, content.begin()), 2u);
+
+    const FileContent expected_content {
+        "a;",
+        " b;",
+        " c;",
+        "d",
+    };
+    EXPECT_EQ(content, expected_content);
+}
@@ -18,13 +18,19 @@ const std::set default_increase_indent_chars = {'{', '('};
 const std::set default_decrease_indent_chars = {'}', ')'};
 constexpr int default_num_of_spaces = 4;
 constexpr bool default_reduce_indent_for_last_decrease_char = false;
+constexpr bool default_progressive_indent = false;
+const std::vector<std::string> default_increase_indent_keywords = {};
+const std::vector<std::string> default_decrease_indent_keywords = {};
 
 const formatter::IndentationOptions baseTestsOptions
 {
     default_increase_indent_chars,
     default_decrease_indent_chars,
     default_num_of_spaces,
-    default_reduce_indent_for_last_decrease_char
+    default_reduce_indent_for_last_decrease_char,
+    default_progressive_indent,
+    default_increase_indent_keywords,
+    default_decrease_indent_keywords
 };
 
 }
@@ -599,3 +605,120 @@ TEST_F(DecreaseIndentationTests, ReduceIndentationForLastDecreaseCharWithProgres
     };
     EXPECT_EQ(content, expected_content);
 }
+
+
+TEST_F(UpdateIndentationTests, IndentOnKeywords)
+{
+    FileContent content {
+        "procedure p;",
+        "begin",
+        "if x then begin",
+        "y := legend;",
+        "end;",
+        "end.",
+    };
+    auto options = baseTestsOptions;
+    options.reduce_indent_for_last_decrease_char = true;
+    options.increase_indentation_keywords = {"begin"};
+    options.decrease_indentation_keywords = {"end"};
+
+    formatter::detail::updateIndentation(content, options);
+
+    const FileContent expected_content {
+        "procedure p;",
+        "begin",
+        "    if x then begin",
+        "        y := legend;",
+        "    end;",
+        "end.",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(UpdateIndentationTests, MixKeywordsWithChars)
+{
+    FileContent content {
+        "#if A",
+        "f() {",
+        "#ifdef B",
+        "g();",
+        "#endif",
+        "}",
+        "#endif",
+    };
+    auto options = baseTestsOptions;
+    options.reduce_indent_for_last_decrease_char = true;
+    options.increase_indentation_keywords = {"#if", "#ifdef"};
+    options.decrease_indentation_keywords = {"#endif"};
+
+    formatter::detail::updateIndentation(content, options);
+
+    const FileContent expected_content {
+        "#if A",
+        "    f() {",
+        "        #ifdef B",
+        "            g();",
+        "        #endif",
+        "    }",
+        "#endif",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(UpdateIndentationTests, IndentCharsTheSameWayWithKeywordsConfigured)
+{
+    const FileContent input {
+        "f(a, {",
+        "x) { y;",
+        "}) } z();",
+        "  })",
+        "w;",
+    };
+    auto keywords_options = baseTestsOptions;
+    keywords_options.reduce_indent_for_last_decrease_char = true;
+    keywords_options.increase_indentation_keywords = {"unused"};
+    auto chars_options = keywords_options;
+    chars_options.increase_indentation_keywords.clear();
+
+    auto keywords_content = input;
+    auto chars_content = input;
+    formatter::detail::updateIndentation(keywords_content, keywords_options);
+    formatter::detail::updateIndentation(chars_content, chars_options);
+
+    EXPECT_EQ(keywords_content, chars_content);
+}
+
+struct IndenterTests : UpdateIndentationTests
+{
+};
+
+TEST_F(IndenterTests, KeepIndentationStateBetweenLines)
+{
+    formatter::detail::Indenter indenter(baseTestsOptions);
+
+    Line first_line = "  first_line();{";
+    Line second_line = "second_line();";
+    indenter.updateLine(first_line);
+    indenter.updateLine(second_line);
+
+    EXPECT_EQ(first_line, "first_line();{");
+    EXPECT_EQ(second_line, "    second_line();");
+}
+
+TEST_F(IndenterTests, ReportWhetherLineWasAlreadyIndented)
+{
+    formatter::detail::Indenter indenter(baseTestsOptions);
+
+    Line first_line = "first_line();{";
+    Line second_line = "\tsecond_line();";
+    Line third_line = "    third_line();";
+    const auto third_line_data = third_line.data();
+
+    EXPECT_TRUE(indenter.updateLine(first_line));
+    EXPECT_FALSE(indenter.updateLine(second_line));
+    EXPECT_TRUE(indenter.updateLine(third_line));
+
+    EXPECT_EQ(second_line, "    second_line();");
+    EXPECT_EQ(third_line, "    third_line();");
+    EXPECT_EQ(third_line.data(), third_line_data);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <FuzzTargets.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+
+/*
+ * Replays the regression corpus, the inputs found by the fuzzers and
+ * the hand written edge cases, through every fuzz target.
+ */
+struct CorpusTests : ::testing::Test
+{
+    CorpusTests() = default;
+    virtual ~CorpusTests() = default;
+
+    static std::vector<std::filesystem::path> corpusFiles()
+    {
+        std::vector<std::filesystem::path> files;
+        for (const auto &entry : std::filesystem::directory_iterator(FUZZ_CORPUS_DIR)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        return files;
+    }
+
+    static std::string readFile(const std::filesystem::path &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+};
+
+
+TEST_F(CorpusTests, FindEveryTargetByName)
+{
+    for (const auto &target : fuzz::targets) {
+        EXPECT_EQ(fuzz::findTarget(target.name), target.target);
+    }
+    EXPECT_EQ(fuzz::findTarget("unknown"), nullptr);
+}
+
+TEST_F(CorpusTests, ReplayCorpusThroughEveryTarget)
+{
+    const auto files = corpusFiles();
+    ASSERT_FALSE(files.empty());
+    fuzz::Limits limits;
+    limits.check_time = false;
+
+    for (const auto &file : files) {
+        const auto data = readFile(file);
+
+        for (const auto &target : fuzz::targets) {
+            SCOPED_TRACE(std::string(target.name) + " " + file.filename().string());
+            EXPECT_NO_THROW(target.target(reinterpret_cast<const std::uint8_t*>(data.data()), data.size(), limits));
+        }
+    }
+}
+
+TEST_F(CorpusTests, AcceptInputWithoutData)
+{
+    for (const auto &target : fuzz::targets) {
+        SCOPED_TRACE(std::string(target.name));
+        EXPECT_NO_THROW(target.target(nullptr, 0, fuzz::Limits {}));
+    }
+}
+
+TEST_F(CorpusTests, ReportWorkOverLimits)
+{
+    fuzz::Limits limits;
+    limits.base_allocations = 0;
+    limits.allocations_per_byte = 0;
+    const std::string input = std::string("\x45\x15{};\x00", 6) + "{\nfirst_statement(); second_statement();\n}\n";
+
+    for (const auto &target : fuzz::targets) {
+        SCOPED_TRACE(std::string(target.name));
+        EXPECT_THROW(target.target(reinterpret_cast<const std::uint8_t*>(input.data()), input.size(), limits),
+                     fuzz::Violation);
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <git/ChangedLines.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+
+struct ChangedLinesTests : ::testing::Test
+{
+    ChangedLinesTests() = default;
+    virtual ~ChangedLinesTests() = default;
+};
+
+
+TEST_F(ChangedLinesTests, ParseHunksOfModifiedFile)
+{
+    const auto changed_lines = git::parseUnifiedDiff(
+        "diff --git a/src/a.c b/src/a.c\n"
+        "index 1111111..2222222 100644\n"
+        "--- a/src/a.c\n"
+        "+++ b/src/a.c\n"
+        "@@ -2 +2 @@ int f() {\n"
+        "-old\n"
+        "+new\n"
+        "@@ -10,0 +11,3 @@\n"
+        "+added\n"
+        "+added\n"
+        "+added\n");
+
+    ASSERT_EQ(changed_lines.size(), 1u);
+    const std::vector<LineRange> expected_ranges {{2, 2}, {11, 13}};
+    EXPECT_EQ(changed_lines.at("src/a.c"), expected_ranges);
+}
+
+TEST_F(ChangedLinesTests, SkipPureDeletionsAndRemovedFiles)
+{
+    const auto changed_lines = git::parseUnifiedDiff(
+        "--- a/a.c\n"
+        "+++ b/a.c\n"
+        "@@ -3,2 +2,0 @@\n"
+        "-removed\n"
+        "-removed\n"
+        "--- a/b.c\n"
+        "+++ /dev/null\n"
+        "@@ -1 +0,0 @@\n"
+        "-removed\n");
+
+    EXPECT_TRUE(changed_lines.empty());
+}
+TEST_F(ChangedLinesTests, DecodeQuotedPaths)
+{
+    const auto changed_lines = git::parseUnifiedDiff(
+        "--- \"a/x\\\"y\\tz\\303\\251.c\"\n"
+        "+++ \"b/x\\\"y\\tz\\303\\251.c\"\n"
+        "@@ -1 +1 @@\n"
+        "-old\n"
+        "+new\n");
+
+    ASSERT_EQ(changed_lines.size(), 1u);
+    EXPECT_EQ(changed_lines.begin()->first, "x\"y\tz\xC3\xA9.c");
+}
+
+
+
+struct ChangedLinesRepositoryTests : ChangedLinesTests
+{
+    ChangedLinesRepositoryTests()
+    {
+        char path_template[] = "/tmp/code-formatter-git-XXXXXX";
+        repository_dir = mkdtemp(path_template);
+
+        git("init -q");
+        git("config user.name tests");
+        git("config user.email tests@localhost");
+    }
+
+    ~ChangedLinesRepositoryTests() override
+    {
+        std::filesystem::remove_all(repository_dir);
+    }
+
+    void git(const std::string &arguments) const
+    {
+        const auto command = "git -C '" + repository_dir + "' " + arguments + " >/dev/null 2>&1";
+        ASSERT_EQ(std::system(command.c_str()), 0) << command;
+    }
+
+    void writeFile(const std::string &name, const std::string &content) const
+    {
+        const auto path = std::filesystem::path(repository_dir) / name;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    std::string repository_dir;
+};
+
+
+TEST_F(ChangedLinesRepositoryTests, ReportLinesChangedInWorkingTree)
+{
+    writeFile("src/a.c", "one\ntwo\nthree\nfour\n");
+    writeFile("b.c", "unchanged\n");
+    git("add -A");
+    git("commit -q -m initial");
+
+    writeFile("src/a.c", "one\nTWO\nthree\nfour\nfive\nsix\n");
+
+    const auto changed_lines = git::changedLines(repository_dir, "HEAD");
+
+    ASSERT_EQ(changed_lines.size(), 1u);
+    const std::vector<LineRange> expected_ranges {{2, 2}, {5, 6}};
+    EXPECT_EQ(changed_lines.at("src/a.c"), expected_ranges);
+}
+
+TEST_F(ChangedLinesRepositoryTests, ReportLinesChangedSinceOlderRevision)
+{
+    writeFile("a.c", "one\n");
+    git("add -A");
+    git("commit -q -m initial");
+    git("tag base");
+
+    writeFile("a.c", "one\ntwo\n");
+    writeFile("c.c", "new\nfile\n");
+    git("add -A");
+    git("commit -q -m second");
+
+    const auto changed_lines = git::changedLines(repository_dir, "base");
+
+    ASSERT_EQ(changed_lines.size(), 2u);
+    EXPECT_EQ(changed_lines.at("a.c"), (std::vector<LineRange>{{2, 2}}));
+    EXPECT_EQ(changed_lines.at("c.c"), (std::vector<LineRange>{{1, 2}}));
+}
+
+TEST_F(ChangedLinesRepositoryTests, IgnoreConfiguredDiffPrefixes)
+{
+    writeFile("a.c", "one\n");
+    git("add -A");
+    git("commit -q -m initial");
+    git("config diff.mnemonicPrefix true");
+
+    writeFile("a.c", "one\ntwo\n");
+
+    const auto changed_lines = git::changedLines(repository_dir, "HEAD");
+
+    ASSERT_EQ(changed_lines.size(), 1u);
+    EXPECT_EQ(changed_lines.at("a.c"), (std::vector<LineRange>{{2, 2}}));
+}
+
+TEST_F(ChangedLinesRepositoryTests, ReturnRepositoryRoot)
+{
+    writeFile("sub/a.c", "one\n");
+
+    const auto root = git::repositoryRoot(repository_dir + "/sub");
+
+    EXPECT_EQ(std::filesystem::canonical(root), std::filesystem::canonical(repository_dir));
+}
+
+TEST_F(ChangedLinesRepositoryTests, ThrowOnUnknownRevision)
+{
+    EXPECT_THROW(git::changedLines(repository_dir, "does-not-exist"), git::GitError);
+}
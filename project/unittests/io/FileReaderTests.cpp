@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <io/FileReader.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+
+struct FileReaderTests : ::testing::Test
+{
+    FileReaderTests() = default;
+    virtual ~FileReaderTests() = default;
+};
+
+
+TEST_F(FileReaderTests, SplitTextIntoLines)
+{
+    const auto content = io::splitLines("first_line();\nsecond_line();\n");
+
+    const FileContent expected_content {
+        "first_line();",
+        "second_line();",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FileReaderTests, KeepLastLineWithoutNewLine)
+{
+    const auto content = io::splitLines("first_line();\nsecond_line();");
+
+    const FileContent expected_content {
+        "first_line();",
+        "second_line();",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FileReaderTests, KeepEmptyLines)
+{
+    const auto content = io::splitLines("\n\nfirst_line();\n\n");
+
+    const FileContent expected_content {
+        "",
+        "",
+        "first_line();",
+        "",
+    };
+    EXPECT_EQ(content, expected_content);
+}
+
+TEST_F(FileReaderTests, ReturnNoLinesForEmptyText)
+{
+    const auto content = io::splitLines("");
+
+    EXPECT_TRUE(content.empty());
+}
+
+
+struct LineBlockReaderTests : FileReaderTests
+{
+    LineBlockReaderTests()
+    {
+        char path_template[] = "/tmp/code-formatter-reader-XXXXXX";
+        const int fd = mkstemp(path_template);
+        close(fd);
+        file_name = path_template;
+    }
+
+    ~LineBlockReaderTests() override
+    {
+        std::remove(file_name.c_str());
+    }
+
+    std::vector<std::string> readBlocks(const std::string &data, const std::size_t block_size) const
+    {
+        std::ofstream(file_name, std::ios::binary) << data;
+
+        io::LineBlockReader reader(file_name.c_str());
+        std::vector<std::string> blocks;
+        std::pmr::string block;
+        std::size_t expected_offset = 0;
+        while (true) {
+            const auto offset = reader.readBlock(block, block_size);
+            EXPECT_EQ(offset, expected_offset);
+            if (block.empty()) {
+                return blocks;
+            }
+            expected_offset += block.size();
+            blocks.emplace_back(block);
+        }
+    }
+
+    std::string file_name;
+};
+
+
+TEST_F(LineBlockReaderTests, EndBlocksAfterLineBreaks)
+{
+    const auto blocks = readBlocks("ab\ncd\nef\ng", 4);
+
+    EXPECT_EQ(blocks, (std::vector<std::string>{"ab\n", "cd\n", "ef\n", "g"}));
+}
+
+TEST_F(LineBlockReaderTests, ExtendBlockWithLongLine)
+{
+    const auto blocks = readBlocks("abcdefgh\ni\n", 2);
+
+    EXPECT_EQ(blocks, (std::vector<std::string>{"abcdefgh\n", "i\n"}));
+}
+
+TEST_F(LineBlockReaderTests, DoNotSplitCrlf)
+{
+    const auto blocks = readBlocks("ab\r\ncd\r\n", 3);
+
+    EXPECT_EQ(blocks, (std::vector<std::string>{"ab\r\n", "cd\r\n"}));
+}
+
+TEST_F(LineBlockReaderTests, EndBlocksAfterCr)
+{
+    const auto blocks = readBlocks("ab\rcd\ref", 4);
+
+    EXPECT_EQ(blocks, (std::vector<std::string>{"ab\r", "cd\r", "ef"}));
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <io/FileWriter.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+
+struct FileWriterTests : ::testing::Test
+{
+    FileWriterTests()
+    {
+        auto path_template = (std::filesystem::temp_directory_path() / "code-formatter-writer-XXXXXX").string();
+        directory = mkdtemp(path_template.data());
+    }
+
+    virtual ~FileWriterTests()
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::filesystem::path directory;
+
+    const FileContent content {
+        "first_line();",
+        "second_line();",
+    };
+};
+
+
+TEST_F(FileWriterTests, WriteLinesWithLf)
+{
+    std::ostringstream output;
+
+    io::writeContent(output, content, io::TextFormat{});
+
+    EXPECT_EQ(output.str(), "first_line();\nsecond_line();\n");
+}
+
+TEST_F(FileWriterTests, RestoreCrlf)
+{
+    std::ostringstream output;
+    io::TextFormat format;
+    format.line_ending = io::LineEnding::CRLF;
+
+    io::writeContent(output, content, format);
+
+    EXPECT_EQ(output.str(), "first_line();\r\nsecond_line();\r\n");
+}
+
+TEST_F(FileWriterTests, RestoreBom)
+{
+    std::ostringstream output;
+    io::TextFormat format;
+    format.has_bom = true;
+
+    io::writeContent(output, content, format);
+
+    EXPECT_EQ(output.str(), "\xEF\xBB\xBF" "first_line();\nsecond_line();\n");
+}
+
+TEST_F(FileWriterTests, DoNotAddNewLineAtEndWhenInputHadNone)
+{
+    std::ostringstream output;
+    io::TextFormat format;
+    format.ends_with_newline = false;
+
+    io::writeContent(output, content, format);
+
+    EXPECT_EQ(output.str(), "first_line();\nsecond_line();");
+}
+
+TEST_F(FileWriterTests, KeepFileWhenStreamedWriteFails)
+{
+    const auto file_name = (directory / "writer.c").string();
+    std::ofstream(file_name, std::ios::binary) << "original";
+
+    EXPECT_THROW(io::writeFile(file_name, [](std::ostream &output) {
+        output << "partial";
+        throw std::runtime_error("failure");
+    }), std::runtime_error);
+
+    std::ifstream input(file_name, std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()), "original");
+    EXPECT_FALSE(std::ifstream(file_name + std::string(io::temporary_file_suffix)).is_open());
+}
+
+TEST_F(FileWriterTests, ReportReasonOfFailedReplace)
+{
+    const auto file_name = (directory / "writer.c").string();
+    std::filesystem::create_directory(file_name);
+    std::ofstream(file_name + "/inside.c") << "original";
+
+    try {
+        io::writeFile(file_name, [](std::ostream &output) {
+            output << "formatted";
+        });
+        FAIL() << "exception not thrown";
+    }
+    catch (const std::filesystem::filesystem_error &e) {
+        EXPECT_EQ(e.code(), std::make_error_code(std::errc::is_a_directory));
+    }
+    EXPECT_FALSE(std::filesystem::exists(file_name + std::string(io::temporary_file_suffix)));
+}
+
+TEST_F(FileWriterTests, WriteMappedFileLikeStream)
+{
+    const auto file_name = (directory / "mapped-writer.c").string();
+    const FileContent long_content {"a", "", "bb", "ccc", "", "dddd", "e"};
+    std::vector<io::TextFormat> formats(4);
+    formats[1].line_ending = io::LineEnding::CRLF;
+    formats[2].has_bom = true;
+    formats[3].ends_with_newline = false;
+
+    for (const auto &format : formats) {
+        for (const auto &tested_content : {FileContent{}, content, long_content}) {
+            for (const unsigned threads : {1u, 3u, 16u}) {
+                io::MappedWriteOptions options;
+                options.threads = threads;
+                options.min_bytes_per_thread = 1;
+
+                io::writeFileMapped(file_name, tested_content, format, options);
+
+                std::ostringstream expected_output;
+                io::writeContent(expected_output, tested_content, format);
+                std::ifstream input(file_name, std::ios::binary);
+                EXPECT_EQ(std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()),
+                          expected_output.str());
+            }
+        }
+    }
+
+}
+
+TEST_F(FileWriterTests, KeepPermissionsOfMappedFile)
+{
+    const auto file_name = (directory / "mapped-permissions.c").string();
+    std::ofstream(file_name, std::ios::binary) << "original";
+    std::filesystem::permissions(file_name, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+
+    io::writeFileMapped(file_name, content, io::TextFormat{});
+
+    EXPECT_EQ(std::filesystem::status(file_name).permissions(),
+              std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <io/InputNormalizer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace std::string_literals;
+
+
+struct InputNormalizerTests : ::testing::Test
+{
+    InputNormalizerTests() = default;
+    virtual ~InputNormalizerTests() = default;
+};
+
+
+TEST_F(InputNormalizerTests, KeepLfInputUnchanged)
+{
+    const auto result = io::normalizeInput("first_line();\nsecond_line();\n");
+
+    EXPECT_EQ(result.text, "first_line();\nsecond_line();\n");
+    EXPECT_EQ(result.format.line_ending, io::LineEnding::LF);
+    EXPECT_FALSE(result.format.has_bom);
+    EXPECT_TRUE(result.format.ends_with_newline);
+}
+
+TEST_F(InputNormalizerTests, NormalizeEmptyViewWithoutData)
+{
+    const auto result = io::normalizeInput(std::string_view());
+
+    EXPECT_TRUE(result.text.empty());
+}
+
+TEST_F(InputNormalizerTests, ConvertCrlfToLf)
+{
+    const auto result = io::normalizeInput("first_line();\r\nsecond_line();\r\n");
+
+    EXPECT_EQ(result.text, "first_line();\nsecond_line();\n");
+    EXPECT_EQ(result.format.line_ending, io::LineEnding::CRLF);
+}
+
+TEST_F(InputNormalizerTests, ConvertCrToLf)
+{
+    const auto result = io::normalizeInput("first_line();\rsecond_line();\r");
+
+    EXPECT_EQ(result.text, "first_line();\nsecond_line();\n");
+    EXPECT_EQ(result.format.line_ending, io::LineEnding::CR);
+}
+
+TEST_F(InputNormalizerTests, RecordLineEndingOfFirstLineBreak)
+{
+    const auto result = io::normalizeInput("first_line();\nsecond_line();\r\n");
+
+    EXPECT_EQ(result.text, "first_line();\nsecond_line();\n");
+    EXPECT_EQ(result.format.line_ending, io::LineEnding::LF);
+}
+
+TEST_F(InputNormalizerTests, ConvertCrlfPlacedAfterLongAsciiBlocks)
+{
+    const std::string long_line(100, 'a');
+
+    const auto result = io::normalizeInput(long_line + "\r\n" + long_line + "\r\n");
+
+    EXPECT_EQ(std::string_view(result.text), long_line + "\n" + long_line + "\n");
+    EXPECT_EQ(result.format.line_ending, io::LineEnding::CRLF);
+}
+
+TEST_F(InputNormalizerTests, StripBom)
+{
+    const auto result = io::normalizeInput("\xEF\xBB\xBF" "first_line();\n");
+
+    EXPECT_EQ(result.text, "first_line();\n");
+    EXPECT_TRUE(result.format.has_bom);
+}
+
+TEST_F(InputNormalizerTests, RecordMissingNewLineAtEndOfFile)
+{
+    const auto result = io::normalizeInput("first_line();");
+
+    EXPECT_EQ(result.text, "first_line();");
+    EXPECT_FALSE(result.format.ends_with_newline);
+}
+
+TEST_F(InputNormalizerTests, AcceptValidMultiByteSequences)
+{
+    const auto input = "za\xC5\xBC\xC3\xB3\xC5\x82\xC4\x87 \xE2\x82\xAC \xF0\x9F\x98\x80\n"s;
+
+    const auto result = io::normalizeInput(input);
+
+    EXPECT_EQ(std::string_view(result.text), input);
+}
+
+TEST_F(InputNormalizerTests, ReportOffsetOfInvalidContinuationByte)
+{
+    try {
+        io::normalizeInput("first_line();\n\xC5" "a");
+        FAIL() << "exception not thrown";
+    }
+    catch (const io::InvalidInputError &e) {
+        EXPECT_EQ(e.offset(), 14u);
+    }
+}
+
+TEST_F(InputNormalizerTests, ReportOffsetOfTruncatedSequence)
+{
+    try {
+        io::normalizeInput("abc\xE2\x82");
+        FAIL() << "exception not thrown";
+    }
+    catch (const io::InvalidInputError &e) {
+        EXPECT_EQ(e.offset(), 3u);
+    }
+}
+
+TEST_F(InputNormalizerTests, ReportOffsetIncludingBom)
+{
+    try {
+        io::normalizeInput("\xEF\xBB\xBF" "a\xFF");
+        FAIL() << "exception not thrown";
+    }
+    catch (const io::InvalidInputError &e) {
+        EXPECT_EQ(e.offset(), 4u);
+    }
+}
+
+TEST_F(InputNormalizerTests, RejectOverlongEncoding)
+{
+    EXPECT_THROW(io::normalizeInput("\xC0\xAF"), io::InvalidInputError);
+    EXPECT_THROW(io::normalizeInput("\xE0\x80\xAF"), io::InvalidInputError);
+    EXPECT_THROW(io::normalizeInput("\xF0\x80\x80\xAF"), io::InvalidInputError);
+}
+
+TEST_F(InputNormalizerTests, RejectSurrogatesAndOutOfRangeCodePoints)
+{
+    EXPECT_THROW(io::normalizeInput("\xED\xA0\x80"), io::InvalidInputError);
+    EXPECT_THROW(io::normalizeInput("\xF4\x90\x80\x80"), io::InvalidInputError);
+}
+
+TEST_F(InputNormalizerTests, ReportInvalidBytePlacedAfterLongAsciiBlock)
+{
+    const std::string long_line(37, 'a');
+
+    try {
+        io::normalizeInput(long_line + "\x80");
+        FAIL() << "exception not thrown";
+    }
+    catch (const io::InvalidInputError &e) {
+        EXPECT_EQ(e.offset(), 37u);
+    }
+}
+
+TEST_F(InputNormalizerTests, KeepBomInFollowingBlock)
+{
+    const auto normalized = io::normalizeInputBlock("\xEF\xBB\xBF" "a\r\n", 10);
+
+    EXPECT_EQ(normalized.text, "\xEF\xBB\xBF" "a\n");
+    EXPECT_FALSE(normalized.format.has_bom);
+}
+
+TEST_F(InputNormalizerTests, ReportOffsetOfInvalidByteInFollowingBlock)
+{
+    try {
+        io::normalizeInputBlock("a\xFF", 10);
+        FAIL() << "exception not thrown";
+    }
+    catch (const io::InvalidInputError &e) {
+        EXPECT_EQ(e.offset(), 11u);
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <json/Json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+
+struct JsonTests : ::testing::Test
+{
+    JsonTests() = default;
+    virtual ~JsonTests() = default;
+};
+
+
+TEST_F(JsonTests, ParseScalars)
+{
+    EXPECT_TRUE(json::parse("null").isNull());
+    EXPECT_TRUE(json::parse(" true ").asBool());
+    EXPECT_FALSE(json::parse("false").asBool());
+    EXPECT_EQ(json::parse("-12").asInteger(), -12);
+    EXPECT_DOUBLE_EQ(json::parse("2.5e1").asNumber(), 25.0);
+    EXPECT_EQ(json::parse("\"text\"").asString(), "text");
+}
+
+TEST_F(JsonTests, ParseNestedValues)
+{
+    const auto value = json::parse(R"({"a": [1, {"b": "c"}], "d": {}})");
+
+    ASSERT_TRUE(value.isObject());
+    EXPECT_EQ(value["a"].asArray().size(), 2u);
+    EXPECT_EQ(value["a"].asArray()[1]["b"].asString(), "c");
+    EXPECT_TRUE(value["d"].asObject().empty());
+    EXPECT_TRUE(value["missing"].isNull());
+    EXPECT_EQ(value.find("missing"), nullptr);
+}
+
+TEST_F(JsonTests, ParseEscapes)
+{
+    EXPECT_EQ(json::parse(R"("a\"b\\c\/d\n\t")").asString(), "a\"b\\c/d\n\t");
+    EXPECT_EQ(json::parse(R"("\u00e9\u20AC")").asString(), "\xC3\xA9\xE2\x82\xAC");
+    EXPECT_EQ(json::parse(R"("\ud83d\ude00")").asString(), "\xF0\x9F\x98\x80");
+}
+
+TEST_F(JsonTests, ThrowOnInvalidText)
+{
+    EXPECT_THROW(json::parse(""), json::ParseError);
+    EXPECT_THROW(json::parse("{\"a\" 1}"), json::ParseError);
+    EXPECT_THROW(json::parse("[1,]"), json::ParseError);
+    EXPECT_THROW(json::parse("\"unterminated"), json::ParseError);
+    EXPECT_THROW(json::parse("tru"), json::ParseError);
+    EXPECT_THROW(json::parse("1 2"), json::ParseError);
+}
+
+TEST_F(JsonTests, ReportOffsetOfError)
+{
+    try {
+        json::parse("[1, x]");
+        FAIL();
+    }
+    catch (const json::ParseError &e) {
+        EXPECT_EQ(e.offset(), 4u);
+    }
+}
+
+TEST_F(JsonTests, ThrowOnTooDeepNesting)
+{
+    EXPECT_THROW(json::parse(std::string(100000, '[')), json::ParseError);
+}
+
+TEST_F(JsonTests, ThrowOnTypeMismatch)
+{
+    const auto value = json::parse("{\"a\": 1.5}");
+
+    EXPECT_THROW(value["a"].asString(), json::TypeError);
+    EXPECT_THROW(value["a"].asInteger(), json::TypeError);
+    EXPECT_THROW(value.asArray(), json::TypeError);
+}
+
+TEST_F(JsonTests, WriteCompactValue)
+{
+    const json::Value value = json::Object {
+        {"id", 3},
+        {"items", json::Array {true, nullptr, 0.5, "a\"b"}},
+    };
+
+    EXPECT_EQ(json::toString(value), R"({"id":3,"items":[true,null,0.5,"a\"b"]})");
+}
+
+TEST_F(JsonTests, WrittenValueParsesBack)
+{
+    const auto text = R"({"text":"line\nnext\u0001","n":-7,"x":[[],{}]})";
+
+    EXPECT_EQ(json::toString(json::parse(text)), text);
+}
+
+TEST_F(JsonTests, WriteStringEscapes)
+{
+    std::ostringstream output;
+    json::writeString(output, "a\\b\r\x02");
+
+    EXPECT_EQ(output.str(), "\"a\\\\b\\r\\u0002\"");
+}
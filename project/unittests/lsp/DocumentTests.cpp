@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <lsp/Document.hpp>
+
+#include <gtest/gtest.h>
+
+
+namespace lsp
+{
+
+void
+PrintTo(const Position &position, std::ostream *output)
+{
+    *output << position.line << ':' << position.character;
+}
+
+}
+
+
+struct DocumentTests : ::testing::Test
+{
+    DocumentTests() = default;
+    virtual ~DocumentTests() = default;
+};
+
+
+TEST_F(DocumentTests, SplitLinesOnEveryLineBreak)
+{
+    const lsp::Document document("a\nb\r\nc\rd", 1, lsp::PositionEncoding::Utf16);
+
+    EXPECT_EQ(document.lineCount(), 4u);
+    EXPECT_EQ(document.offsetAt({1, 0}), 2u);
+    EXPECT_EQ(document.offsetAt({2, 0}), 5u);
+    EXPECT_EQ(document.offsetAt({3, 0}), 7u);
+    EXPECT_EQ(document.positionAt(3), (lsp::Position {1, 1}));
+    EXPECT_EQ(document.positionAt(8), (lsp::Position {3, 1}));
+}
+
+TEST_F(DocumentTests, CountTrailingLineBreakAsLine)
+{
+    const lsp::Document document("a\r", 1, lsp::PositionEncoding::Utf16);
+
+    EXPECT_EQ(document.lineCount(), 2u);
+    EXPECT_EQ(document.positionAt(2), (lsp::Position {1, 0}));
+}
+
+TEST_F(DocumentTests, ClampPositionsToLineAndDocument)
+{
+    const lsp::Document document("ab\ncd", 1, lsp::PositionEncoding::Utf16);
+
+    EXPECT_EQ(document.offsetAt({0, 10}), 2u);
+    EXPECT_EQ(document.offsetAt({5, 0}), 5u);
+}
+
+TEST_F(DocumentTests, CountUtf16CodeUnits)
+{
+    /*
+     * "é" takes two bytes and one unit, the emoji four bytes and two units.
+     */
+    const lsp::Document document("\xC3\xA9x\xF0\x9F\x98\x80y", 1, lsp::PositionEncoding::Utf16);
+
+    EXPECT_EQ(document.offsetAt({0, 1}), 2u);
+    EXPECT_EQ(document.offsetAt({0, 2}), 3u);
+    EXPECT_EQ(document.offsetAt({0, 4}), 7u);
+    EXPECT_EQ(document.positionAt(7), (lsp::Position {0, 4}));
+    EXPECT_EQ(document.positionAt(8), (lsp::Position {0, 5}));
+}
+
+TEST_F(DocumentTests, UseByteOffsetsForUtf8)
+{
+    const lsp::Document document("\xC3\xA9x", 1, lsp::PositionEncoding::Utf8);
+
+    EXPECT_EQ(document.offsetAt({0, 2}), 2u);
+    EXPECT_EQ(document.positionAt(3), (lsp::Position {0, 3}));
+}
+
+TEST_F(DocumentTests, ReplaceRangeAndReindexLines)
+{
+    lsp::Document document("int a;\nint b;\n", 1, lsp::PositionEncoding::Utf16);
+
+    document.replace({0, 4}, {1, 5}, "x;\nint y");
+
+    EXPECT_EQ(document.text(), "int x;\nint y;\n");
+    EXPECT_EQ(document.offsetAt({1, 4}), 11u);
+
+    document.replace({2, 0}, {2, 0}, "}\n");
+
+    EXPECT_EQ(document.text(), "int x;\nint y;\n}\n");
+    EXPECT_EQ(document.lineCount(), 4u);
+}
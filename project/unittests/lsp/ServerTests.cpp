@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <lsp/Server.hpp>
+#include <lsp/Transport.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+
+class FakeFileSystem : public config::FileSystem
+{
+public:
+    std::optional<std::string> readFile(const std::filesystem::path &path) override
+    {
+        const auto file_it = files.find(path.string());
+        if (file_it == files.end()) {
+            return std::nullopt;
+        }
+        return file_it->second;
+    }
+
+    std::map<std::string, std::string> files;
+};
+
+
+json::Value
+position(const std::size_t line, const std::size_t character)
+{
+    return json::Object {{"line", line}, {"character", character}};
+}
+
+
+json::Value
+range(const std::size_t start_line, const std::size_t start_character,
+      const std::size_t end_line, const std::size_t end_character)
+{
+    return json::Object {{"start", position(start_line, start_character)},
+                         {"end", position(end_line, end_character)}};
+}
+
+
+json::Value
+textEdit(const json::Value &edit_range, const std::string &text)
+{
+    return json::Object {{"range", edit_range}, {"newText", text}};
+}
+
+}
+
+
+/*
+ * Plays the part of the editor: the messages are sent to the server at
+ * once and its responses are collected by id.
+ */
+struct ServerTests : ::testing::Test
+{
+    ServerTests() = default;
+    virtual ~ServerTests() = default;
+
+    void request(const int id, const std::string &method, json::Value params = json::Object {})
+    {
+        send(json::Object {{"jsonrpc", "2.0"}, {"id", id}, {"method", method}, {"params", std::move(params)}});
+    }
+
+    void notify(const std::string &method, json::Value params = json::Object {})
+    {
+        send(json::Object {{"jsonrpc", "2.0"}, {"method", method}, {"params", std::move(params)}});
+    }
+
+    void send(const json::Value &message)
+    {
+        lsp::writeMessage(input, json::toString(message));
+    }
+
+    void initialize()
+    {
+        request(0, "initialize", json::Object {{"capabilities", json::Object {}}});
+        notify("initialized");
+    }
+
+    void open(const std::string &uri, const std::string &text)
+    {
+        notify("textDocument/didOpen",
+               json::Object {{"textDocument", json::Object {{"uri", uri},
+                                                             {"languageId", "c"},
+                                                             {"version", 1},
+                                                             {"text", text}}}});
+    }
+
+    void change(const std::string &uri, const int version, json::Value changes)
+    {
+        notify("textDocument/didChange",
+               json::Object {{"textDocument", json::Object {{"uri", uri}, {"version", version}}},
+                             {"contentChanges", std::move(changes)}});
+    }
+
+    int run()
+    {
+        lsp::Server server(testsOptions(), file_system);
+        std::istringstream server_input(input.str());
+        std::stringstream server_output;
+        const auto exit_code = server.run(server_input, server_output);
+
+        while (const auto content = lsp::readMessage(server_output)) {
+            auto message = json::parse(*content);
+            responses.emplace_back(std::move(message));
+        }
+
+        return exit_code;
+    }
+
+    const json::Value& responseTo(const int id) const
+    {
+        for (const auto &response : responses) {
+            if (response["id"] == json::Value(id)) {
+                return response;
+            }
+        }
+
+        static const json::Value missing;
+        return missing;
+    }
+
+    static json::Value uriParams(const std::string &uri)
+    {
+        return json::Object {{"textDocument", json::Object {{"uri", uri}}}};
+    }
+
+    FakeFileSystem file_system;
+    std::ostringstream input;
+    std::vector<json::Value> responses;
+};
+
+
+TEST_F(ServerTests, FormatDocumentsEditedByClient)
+{
+    const std::string uri = "file:///project/main.c";
+
+    initialize();
+    open(uri, "int main() {\nreturn 0;\n}\n");
+    request(1, "textDocument/formatting", uriParams(uri));
+
+    change(uri, 2, json::Array {json::Object {{"range", range(1, 0, 1, 0)}, {"text", "f();\n"}}});
+    request(2, "textDocument/formatting", uriParams(uri));
+
+    request(3, "textDocument/rangeFormatting",
+            json::Object {{"textDocument", json::Object {{"uri", uri}}}, {"range", range(2, 0, 3, 0)}});
+
+    change(uri, 3, json::Array {json::Object {{"range", range(3, 0, 3, 0)}, {"text", "  "}}});
+    request(4, "textDocument/onTypeFormatting",
+            json::Object {{"textDocument", json::Object {{"uri", uri}}},
+                          {"position", position(3, 3)},
+                          {"ch", "}"},
+                          {"options", json::Object {{"tabSize", 4}, {"insertSpaces", true}}}});
+
+    request(5, "shutdown");
+    notify("exit");
+
+    ASSERT_EQ(run(), 0);
+
+    const auto &capabilities = responseTo(0)["result"]["capabilities"];
+    EXPECT_EQ(capabilities["positionEncoding"].asString(), "utf-16");
+    EXPECT_TRUE(capabilities["documentRangeFormattingProvider"].asBool());
+
+    EXPECT_EQ(responseTo(1)["result"], (json::Array {textEdit(range(1, 0, 1, 0), "    ")}));
+    EXPECT_EQ(responseTo(2)["result"], (json::Array {textEdit(range(1, 0, 1, 0), "    "),
+                                                     textEdit(range(2, 0, 2, 0), "    ")}));
+    EXPECT_EQ(responseTo(3)["result"], (json::Array {textEdit(range(2, 0, 2, 0), "    ")}));
+    EXPECT_EQ(responseTo(4)["result"], (json::Array {textEdit(range(3, 0, 3, 2), "")}));
+    EXPECT_TRUE(responseTo(5)["result"].isNull());
+    EXPECT_TRUE(responseTo(5).find("result"));
+}
+
+TEST_F(ServerTests, FormatLineClosedByTypedLineBreak)
+{
+    const std::string uri = "untitled:Untitled-1";
+
+    initialize();
+    open(uri, "{\nx;\n");
+    request(1, "textDocument/onTypeFormatting",
+            json::Object {{"textDocument", json::Object {{"uri", uri}}}, {"position", position(2, 0)}, {"ch", "\n"}});
+
+    run();
+
+    EXPECT_EQ(responseTo(1)["result"], (json::Array {textEdit(range(1, 0, 1, 0), "    ")}));
+}
+
+TEST_F(ServerTests, ReplaceWholeTextOnFullChange)
+{
+    const std::string uri = "file:///a.c";
+
+    initialize();
+    open(uri, "a;\n");
+    change(uri, 2, json::Array {json::Object {{"text", "{\nb;\n}\n"}}});
+    request(1, "textDocument/formatting", uriParams(uri));
+
+    run();
+
+    EXPECT_EQ(responseTo(1)["result"], (json::Array {textEdit(range(1, 0, 1, 0), "    ")}));
+}
+
+TEST_F(ServerTests, ResolveOptionsFromConfigFileNextToDocument)
+{
+    file_system.files["/my project/.code-formatter"] = "num_of_spaces = 2\n";
+    const std::string uri = "file:///my%20project/a.c";
+
+    initialize();
+    open(uri, "{\nb;\n}\n");
+    request(1, "textDocument/formatting", uriParams(uri));
+
+    run();
+
+    EXPECT_EQ(responseTo(1)["result"], (json::Array {textEdit(range(1, 0, 1, 0), "  ")}));
+}
+
+TEST_F(ServerTests, NegotiateUtf8Positions)
+{
+    const std::string uri = "file:///a.c";
+
+    request(0, "initialize",
+            json::Object {{"capabilities",
+                           json::Object {{"general",
+                                          json::Object {{"positionEncodings", json::Array {"utf-8", "utf-16"}}}}}}});
+    open(uri, "{\xC3\xA9;x;\n");
+    request(1, "textDocument/formatting", uriParams(uri));
+
+    run();
+
+    EXPECT_EQ(responseTo(0)["result"]["capabilities"]["positionEncoding"].asString(), "utf-8");
+    EXPECT_EQ(responseTo(1)["result"], (json::Array {textEdit(range(0, 4, 0, 4), "\n    ")}));
+}
+
+TEST_F(ServerTests, ReportErrorsToRequests)
+{
+    request(1, "textDocument/formatting", uriParams("file:///a.c"));
+    initialize();
+    request(2, "textDocument/formatting", uriParams("file:///a.c"));
+    request(3, "textDocument/hover", uriParams("file:///a.c"));
+    request(4, "textDocument/formatting", json::Object {{"textDocument", 7}});
+    open("file:///b.c", "\xFF\n");
+    request(5, "textDocument/formatting", uriParams("file:///b.c"));
+    input << "Content-Length: 1\r\n\r\n{";
+
+    run();
+
+    EXPECT_EQ(responseTo(1)["error"]["code"].asInteger(), -32002);
+    EXPECT_EQ(responseTo(2)["error"]["code"].asInteger(), -32602);
+    EXPECT_EQ(responseTo(3)["error"]["code"].asInteger(), -32601);
+    EXPECT_EQ(responseTo(4)["error"]["code"].asInteger(), -32602);
+    EXPECT_EQ(responseTo(5)["error"]["code"].asInteger(), -32803);
+    ASSERT_FALSE(responses.empty());
+    EXPECT_EQ(responses.back()["error"]["code"].asInteger(), -32700);
+    EXPECT_TRUE(responses.back()["id"].isNull());
+}
+
+TEST_F(ServerTests, ExitWithoutShutdownIsAnError)
+{
+    initialize();
+    notify("exit");
+    request(1, "shutdown");
+
+    EXPECT_EQ(run(), 1);
+    EXPECT_TRUE(responseTo(1).isNull());
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <lsp/Transport.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+
+struct TransportTests : ::testing::Test
+{
+    TransportTests() = default;
+    virtual ~TransportTests() = default;
+};
+
+
+TEST_F(TransportTests, ReadMessagesOneByOne)
+{
+    std::istringstream input("Content-Length: 2\r\n\r\n{}"
+                             "content-length: 4\r\nContent-Type: application/vscode-jsonrpc; charset=utf-8\r\n\r\nnull");
+
+    EXPECT_EQ(lsp::readMessage(input), "{}");
+    EXPECT_EQ(lsp::readMessage(input), "null");
+    EXPECT_EQ(lsp::readMessage(input), std::nullopt);
+}
+
+TEST_F(TransportTests, ThrowOnMissingContentLength)
+{
+    std::istringstream input("Content-Type: text\r\n\r\n{}");
+
+    EXPECT_THROW(lsp::readMessage(input), lsp::ProtocolError);
+}
+
+TEST_F(TransportTests, ThrowOnTruncatedContent)
+{
+    std::istringstream input("Content-Length: 10\r\n\r\n{}");
+
+    EXPECT_THROW(lsp::readMessage(input), lsp::ProtocolError);
+}
+
+TEST_F(TransportTests, WriteFramedMessage)
+{
+    std::ostringstream output;
+    lsp::writeMessage(output, "{\"a\":1}");
+
+    EXPECT_EQ(output.str(), "Content-Length: 7\r\n\r\n{\"a\":1}");
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <memory/Arena.hpp>
+
+#include <gtest/gtest.h>
+
+#include <FileContent.hpp>
+
+
+struct ArenaTests : ::testing::Test
+{
+    ArenaTests() = default;
+    virtual ~ArenaTests() = default;
+
+    memory::CountingResource upstream {std::pmr::new_delete_resource()};
+};
+
+
+TEST_F(ArenaTests, AllocateInitialBufferOnce)
+{
+    memory::Arena arena(1024, &upstream);
+
+    EXPECT_EQ(upstream.statistics().allocations, 1u);
+    EXPECT_EQ(arena.statistics().capacity, 1024u);
+}
+
+TEST_F(ArenaTests, ServeSmallAllocationsFromInitialBuffer)
+{
+    memory::Arena arena(4096, &upstream);
+
+    {
+        FileContent content(&arena);
+        content.emplace_back("first line which is long enough to not fit into the small string buffer");
+        content.emplace_back("second line which is long enough to not fit into the small string buffer");
+    }
+
+    EXPECT_EQ(upstream.statistics().allocations, 1u);
+    EXPECT_EQ(arena.statistics().cycle_upstream_allocations, 0u);
+    EXPECT_GE(arena.statistics().cycle_allocations, 4u);
+}
+
+TEST_F(ArenaTests, GrowBufferOnResetWhenCycleDidNotFit)
+{
+    memory::Arena arena(256, &upstream);
+
+    EXPECT_NE(arena.allocate(1000), nullptr);
+    EXPECT_GT(arena.statistics().cycle_upstream_allocations, 0u);
+
+    arena.reset();
+    const auto upstream_allocations = upstream.statistics().allocations;
+    EXPECT_GE(arena.statistics().capacity, 1000u);
+
+    EXPECT_NE(arena.allocate(1000), nullptr);
+    arena.reset();
+
+    EXPECT_EQ(upstream.statistics().allocations, upstream_allocations);
+    EXPECT_EQ(arena.statistics().resets, 2u);
+}
+
+TEST_F(ArenaTests, ReleaseEverythingToUpstreamOnDestruction)
+{
+    {
+        memory::Arena arena(256, &upstream);
+        EXPECT_NE(arena.allocate(1000), nullptr);
+        EXPECT_NE(arena.allocate(3000), nullptr);
+    }
+
+    EXPECT_EQ(upstream.statistics().allocations, upstream.statistics().deallocations);
+}
+
+TEST_F(ArenaTests, ReuseSameMemoryAfterReset)
+{
+    memory::Arena arena(1024, &upstream);
+
+    auto *first = arena.allocate(100);
+    arena.reset();
+    auto *second = arena.allocate(100);
+
+    EXPECT_EQ(first, second);
+}
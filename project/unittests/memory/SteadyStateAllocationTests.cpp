@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <memory/Arena.hpp>
+
+#include <formatter/Formatter.hpp>
+#include <io/FileReader.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+
+namespace
+{
+
+std::atomic<std::size_t> global_allocations {0};
+
+}
+
+
+void* operator new(std::size_t size)
+{
+    ++global_allocations;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+namespace
+{
+
+std::string
+generateFile(const int functions)
+{
+    std::string file;
+    for (int i = 0; i < functions; ++i) {
+        file += "void function_number_" + std::to_string(i) + "(int argument) {\r\n"
+                "first_statement_of_the_function(); second_statement_of_the_function();\r\n"
+                "  if (argument) {\r\n"
+                "inner_statement_with_quite_a_long_name(argument);\r\n"
+                "}\r\n"
+                "}\r\n";
+    }
+
+    return file;
+}
+
+}
+
+
+struct SteadyStateAllocationTests : ::testing::Test
+{
+    SteadyStateAllocationTests() = default;
+    virtual ~SteadyStateAllocationTests() = default;
+};
+
+
+TEST_F(SteadyStateAllocationTests, FormatBatchWithoutGlobalHeapAllocations)
+{
+    const auto options = testsOptions();
+    const std::string files[] = {generateFile(10), generateFile(200), generateFile(50)};
+    memory::Arena arena(1024);
+
+    std::size_t steady_state_allocations = 0;
+    std::size_t steady_state_upstream_allocations = 0;
+
+    for (int round = 0; round < 5; ++round) {
+        for (const auto &file : files) {
+            const auto allocations_before = global_allocations.load();
+            {
+                const auto normalized = io::normalizeInput(file, &arena);
+                auto content = io::splitLines(normalized.text, &arena);
+                formatter::format(content, options);
+            }
+            const auto allocations = global_allocations.load() - allocations_before;
+            const auto upstream_allocations = arena.statistics().cycle_upstream_allocations;
+            arena.reset();
+
+            if (round > 0) {
+                steady_state_allocations += allocations;
+                steady_state_upstream_allocations += upstream_allocations;
+            }
+        }
+    }
+
+    EXPECT_EQ(steady_state_allocations, 0u);
+    EXPECT_EQ(steady_state_upstream_allocations, 0u);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <pipeline/Pipeline.hpp>
+#include <formatter/Formatter.hpp>
+#include <io/FileReader.hpp>
+#include <io/FileWriter.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+
+struct PipelineTests : ::testing::Test
+{
+    PipelineTests()
+    {
+        char path_template[] = "/tmp/code-formatter-pipeline-XXXXXX";
+        const int fd = mkstemp(path_template);
+        close(fd);
+        file_name = path_template;
+
+        pipeline_options.block_size = 8;
+        pipeline_options.blocks = 2;
+    }
+
+    ~PipelineTests() override
+    {
+        std::remove(file_name.c_str());
+    }
+
+    void writeInput(const std::string &data) const
+    {
+        std::ofstream(file_name, std::ios::binary) << data;
+    }
+
+    std::string formatInPipeline() const
+    {
+        std::ostringstream output;
+        pipeline::formatFile(file_name.c_str(), options, output, pipeline_options);
+        return output.str();
+    }
+
+    std::string formatWholeFile() const
+    {
+        io::TextFormat format;
+        auto content = io::readFile(file_name.c_str(), format);
+        formatter::format(content, options);
+
+        std::ostringstream output;
+        io::writeContent(output, content, format);
+        return output.str();
+    }
+
+    std::string file_name;
+    formatter::FormatterOptions options = testsOptions();
+    pipeline::PipelineOptions pipeline_options;
+};
+
+
+TEST_F(PipelineTests, FormatLikeWholeFileFormatting)
+{
+    const std::vector<std::string> inputs {
+        "",
+        "\n",
+        "a();",
+        "void f() {\nfirst_line(); second_line();\nif (x) {\ny();\n}\n}\n",
+        "void f() {\r\nfirst_line(); second_line();\r\n}\r\n",
+        "void f() {\rfirst_line(); second_line();\r}",
+        "\xEF\xBB\xBFvoid f() {\na_line_much_longer_than_the_block_size();\n}",
+        "\n\n{\n\n}\n\n",
+    };
+
+    for (const auto &input : inputs) {
+        writeInput(input);
+
+        EXPECT_EQ(formatInPipeline(), formatWholeFile()) << input;
+    }
+}
+
+TEST_F(PipelineTests, ReportStatisticsOfAllBlocks)
+{
+    writeInput("void f() {\n    a();\nb();\n}\n");
+
+    std::ostringstream output;
+    const auto statistics = pipeline::formatFile(file_name.c_str(), options, output, pipeline_options);
+
+    EXPECT_EQ(statistics.lines, 4u);
+    EXPECT_EQ(statistics.unchanged_lines, 3u);
+}
+
+TEST_F(PipelineTests, ReportInvalidInputOffsetInWholeFile)
+{
+    writeInput("first_line();\nsecond_line();\n\xFF\n");
+
+    try {
+        formatInPipeline();
+        FAIL() << "InvalidInputError not thrown";
+    }
+    catch (const io::InvalidInputError &e) {
+        EXPECT_EQ(e.offset(), 29u);
+    }
+}
+
+TEST_F(PipelineTests, ThrowWhenFileDoesNotExist)
+{
+    std::remove(file_name.c_str());
+
+    EXPECT_THROW(formatInPipeline(), std::system_error);
+}
+
+TEST_F(PipelineTests, TraceEveryBlockOfEveryStage)
+{
+    writeInput("void f() {\nfirst_line();\nsecond_line();\n}\n");
+
+    trace::Tracer tracer;
+    pipeline_options.tracer = &tracer;
+    formatInPipeline();
+
+    std::ostringstream trace;
+    tracer.write(trace);
+    const auto count = [&trace](const std::string &name) {
+        const auto text = trace.str();
+        const auto event = "{\"name\":\"" + name + "\"";
+        std::size_t found = 0;
+        for (auto pos = text.find(event); pos != std::string::npos; pos = text.find(event, pos + 1)) {
+            ++found;
+        }
+        return found;
+    };
+
+    EXPECT_EQ(count("reader"), 1u);
+    EXPECT_EQ(count("formatter"), 1u);
+    EXPECT_EQ(count("writer"), 1u);
+    EXPECT_GE(count("read"), 2u);
+    EXPECT_EQ(count("format"), count("write"));
+    EXPECT_NE(trace.str().find("\"file\":\"" + file_name + "\""), std::string::npos);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <pipeline/SpscQueue.hpp>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+
+struct SpscQueueTests : ::testing::Test
+{
+    SpscQueueTests() = default;
+    virtual ~SpscQueueTests() = default;
+};
+
+
+TEST_F(SpscQueueTests, RoundCapacityUpToPowerOfTwo)
+{
+    pipeline::SpscQueue<int> queue(5);
+
+    EXPECT_EQ(queue.capacity(), 8u);
+}
+
+TEST_F(SpscQueueTests, RejectPushWhenFullAndPopWhenEmpty)
+{
+    pipeline::SpscQueue<int> queue(2);
+    int value = 1;
+
+    EXPECT_TRUE(queue.tryPush(value));
+    EXPECT_TRUE(queue.tryPush(value));
+    EXPECT_FALSE(queue.tryPush(value));
+
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST_F(SpscQueueTests, PassValuesInOrderBetweenThreads)
+{
+    constexpr int values = 100000;
+    pipeline::SpscQueue<int> queue(16);
+
+    std::thread producer([&queue] {
+        for (int i = 0; i < values; ++i) {
+            int value = i;
+            while (not queue.tryPush(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected_value = 0;
+    while (expected_value < values) {
+        int value = -1;
+        if (queue.tryPop(value)) {
+            ASSERT_EQ(value, expected_value);
+            ++expected_value;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include <trace/Tracer.hpp>
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+struct TracerTests : ::testing::Test
+{
+    TracerTests() = default;
+    virtual ~TracerTests() = default;
+
+    std::string writeTrace() const
+    {
+        std::ostringstream output;
+        tracer.write(output);
+        return output.str();
+    }
+
+    static std::vector<std::string> events(const std::string &trace, const std::string &name)
+    {
+        std::vector<std::string> found;
+        std::istringstream lines(trace);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.find("{\"name\":\"" + name + "\"") == 0) {
+                found.push_back(line);
+            }
+        }
+
+        return found;
+    }
+
+    static std::string field(const std::string &event, const std::string &name)
+    {
+        const auto begin = event.find("\"" + name + "\":") + name.size() + 3;
+        return event.substr(begin, event.find_first_of(",}", begin) - begin);
+    }
+
+    trace::Tracer tracer;
+};
+
+
+TEST_F(TracerTests, WriteEmptyTrace)
+{
+    EXPECT_EQ(writeTrace(), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n");
+}
+
+TEST_F(TracerTests, RecordNestedSpansWithFile)
+{
+    {
+        trace::Span file_span(&tracer, "file", "dir/a.c");
+        trace::Span read_span(&tracer, "read");
+    }
+    {
+        trace::Span write_span(&tracer, "write");
+    }
+
+    const auto trace = writeTrace();
+    const auto file_events = events(trace, "file");
+    const auto read_events = events(trace, "read");
+    const auto write_events = events(trace, "write");
+    ASSERT_EQ(file_events.size(), 1u);
+    ASSERT_EQ(read_events.size(), 1u);
+    ASSERT_EQ(write_events.size(), 1u);
+
+    EXPECT_NE(file_events[0].find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(file_events[0].find("\"args\":{\"file\":\"dir/a.c\"}"), std::string::npos);
+    EXPECT_NE(read_events[0].find("\"args\":{\"file\":\"dir/a.c\"}"), std::string::npos);
+    EXPECT_EQ(write_events[0].find("\"args\""), std::string::npos);
+
+    EXPECT_LE(std::stod(field(file_events[0], "ts")), std::stod(field(read_events[0], "ts")));
+    EXPECT_GE(std::stod(field(file_events[0], "dur")), std::stod(field(read_events[0], "dur")));
+}
+
+TEST_F(TracerTests, EscapeFileNames)
+{
+    {
+        trace::Span span(&tracer, "file", "a \"quoted\"\\name\n");
+    }
+
+    const auto file_events = events(writeTrace(), "file");
+    ASSERT_EQ(file_events.size(), 1u);
+    EXPECT_NE(file_events[0].find("\"file\":\"a \\\"quoted\\\"\\\\name\\n\""), std::string::npos);
+}
+
+TEST_F(TracerTests, RecordEveryThreadSeparately)
+{
+    constexpr int threads_count = 4;
+    constexpr int spans_per_thread = 3000;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threads_count; ++i) {
+        threads.emplace_back([this] {
+            for (int j = 0; j < spans_per_thread; ++j) {
+                trace::Span span(&tracer, "format");
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto trace = writeTrace();
+    const auto format_events = events(trace, "format");
+    EXPECT_EQ(format_events.size(), static_cast<std::size_t>(threads_count * spans_per_thread));
+    EXPECT_EQ(events(trace, "thread_name").size(), static_cast<std::size_t>(threads_count));
+
+    std::set<std::string> thread_ids;
+    for (const auto &event : format_events) {
+        thread_ids.insert(field(event, "tid"));
+    }
+    EXPECT_EQ(thread_ids.size(), static_cast<std::size_t>(threads_count));
+}
+
+TEST_F(TracerTests, KeepSpansOfTracersApart)
+{
+    {
+        trace::Span span(&tracer, "first");
+    }
+    {
+        trace::Tracer other_tracer;
+        trace::Span span(&other_tracer, "second");
+    }
+    {
+        trace::Tracer other_tracer;
+        trace::Span span(&other_tracer, "third");
+    }
+
+    const auto trace = writeTrace();
+    EXPECT_EQ(events(trace, "first").size(), 1u);
+    EXPECT_TRUE(events(trace, "second").empty());
+    EXPECT_TRUE(events(trace, "third").empty());
+}
+
+TEST_F(TracerTests, IgnoreSpansWithoutTracer)
+{
+    trace::Span span(nullptr, "file", "a.c");
+    trace::Span nested_span(nullptr, "read");
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <traversal/DirectoryWalker.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+
+struct DirectoryWalkerTests : ::testing::Test
+{
+    DirectoryWalkerTests()
+    {
+        char path_template[] = "/tmp/code-formatter-walk-XXXXXX";
+        root = mkdtemp(path_template);
+    }
+
+    ~DirectoryWalkerTests() override
+    {
+        std::filesystem::remove_all(root);
+    }
+
+    void writeFile(const std::string &name, const std::string &content = "") const
+    {
+        const auto path = root / name;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    std::set<std::string> walk(traversal::WalkerOptions options = {}) const
+    {
+        std::mutex mutex;
+        std::set<std::string> found;
+
+        traversal::DirectoryWalker(std::move(options)).walk({root}, [&](const std::filesystem::path &path) {
+            std::lock_guard<std::mutex> lock(mutex);
+            found.insert(path.lexically_relative(root).string());
+        });
+
+        return found;
+    }
+
+    std::filesystem::path root;
+};
+
+
+TEST_F(DirectoryWalkerTests, FindFilesRecursively)
+{
+    writeFile("a.c");
+    writeFile("src/b.c");
+    writeFile("src/deep/er/c.c");
+
+    EXPECT_EQ(walk(), (std::set<std::string>{"a.c", "src/b.c", "src/deep/er/c.c"}));
+}
+
+TEST_F(DirectoryWalkerTests, FindManyFilesWithManyThreads)
+{
+    std::set<std::string> expected;
+    for (int directory = 0; directory < 20; ++directory) {
+        for (int file = 0; file < 10; ++file) {
+            const auto name = "d" + std::to_string(directory) + "/s/f" + std::to_string(file) + ".c";
+            writeFile(name);
+            expected.insert(name);
+        }
+    }
+
+    traversal::WalkerOptions options;
+    options.threads = 8;
+
+    EXPECT_EQ(walk(options), expected);
+}
+
+TEST_F(DirectoryWalkerTests, SpreadFilesOfOneDirectoryOverThreads)
+{
+    for (int file = 0; file < 64; ++file) {
+        writeFile("f" + std::to_string(file) + ".c");
+    }
+
+    traversal::WalkerOptions options;
+    options.threads = 4;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::set<std::thread::id> threads;
+    bool first_file = true;
+    traversal::DirectoryWalker(options).walk({root}, [&](const std::filesystem::path &) {
+        std::unique_lock<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        condition.notify_all();
+        if (std::exchange(first_file, false)) {
+            condition.wait_for(lock, std::chrono::seconds(5), [&] { return threads.size() > 1; });
+        }
+    });
+
+    EXPECT_GT(threads.size(), 1u);
+}
+
+TEST_F(DirectoryWalkerTests, ApplyIncludeAndExcludePatterns)
+{
+    writeFile("a.c");
+    writeFile("a.h");
+    writeFile("src/b.c");
+    writeFile("third_party/c.c");
+
+    traversal::WalkerOptions options;
+    options.include_patterns = {"*.c"};
+    options.exclude_patterns = {"third_party"};
+
+    EXPECT_EQ(walk(options), (std::set<std::string>{"a.c", "src/b.c"}));
+}
+
+TEST_F(DirectoryWalkerTests, MatchPatternsWithSeparatorAgainstRelativePath)
+{
+    writeFile("src/a.c");
+    writeFile("src/gen/b.c");
+
+    traversal::WalkerOptions options;
+    options.exclude_patterns = {"src/gen/**"};
+
+    EXPECT_EQ(walk(options), (std::set<std::string>{"src/a.c"}));
+}
+
+TEST_F(DirectoryWalkerTests, HonourIgnoreFilesOfParentDirectories)
+{
+    writeFile(".gitignore", "*.o\nbuild/\n");
+    writeFile("a.c");
+    writeFile("a.o");
+    writeFile("build/b.c");
+    writeFile("src/.code-formatter-ignore", "generated.c\n!keep.o\n");
+    writeFile("src/generated.c");
+    writeFile("src/keep.o");
+    writeFile("src/other.o");
+
+    traversal::WalkerOptions options;
+    options.exclude_patterns = {".gitignore", ".code-formatter-ignore"};
+
+    EXPECT_EQ(walk(options), (std::set<std::string>{"a.c", "src/keep.o"}));
+}
+
+TEST_F(DirectoryWalkerTests, AnchorIgnoreRulesToDirectoryOfIgnoreFile)
+{
+    writeFile("src/.gitignore", "/local.c\n");
+    writeFile("src/local.c");
+    writeFile("src/sub/local.c");
+
+    traversal::WalkerOptions options;
+    options.include_patterns = {"*.c"};
+
+    EXPECT_EQ(walk(options), (std::set<std::string>{"src/sub/local.c"}));
+}
+
+TEST_F(DirectoryWalkerTests, SkipGitDirectory)
+{
+    writeFile(".git/config");
+    writeFile("a.c");
+
+    EXPECT_EQ(walk(), (std::set<std::string>{"a.c"}));
+}
+
+TEST_F(DirectoryWalkerTests, PassFilesGivenDirectly)
+{
+    writeFile("a.h");
+
+    traversal::WalkerOptions options;
+    options.include_patterns = {"*.c"};
+
+    std::vector<std::filesystem::path> found;
+    traversal::DirectoryWalker(options).walk({root / "a.h"}, [&](const std::filesystem::path &path) {
+        found.push_back(path);
+    });
+
+    EXPECT_EQ(found, (std::vector<std::filesystem::path>{root / "a.h"}));
+}
+
+TEST_F(DirectoryWalkerTests, SkipSymbolicLinks)
+{
+    writeFile("real.c");
+    writeFile("dir/b.c");
+    std::filesystem::create_symlink(root / "real.c", root / "link.c");
+    std::filesystem::create_directory_symlink(root / "dir", root / "link_dir");
+
+    EXPECT_EQ(walk(), (std::set<std::string>{"real.c", "dir/b.c"}));
+}
+
+TEST_F(DirectoryWalkerTests, PropagateCallbackException)
+{
+    writeFile("a.c");
+
+    traversal::WalkerOptions options;
+    options.threads = 4;
+
+    EXPECT_THROW(traversal::DirectoryWalker(options).walk({root}, [](const std::filesystem::path &) {
+        throw std::runtime_error("failure");
+    }), std::runtime_error);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <traversal/GlobPattern.hpp>
+
+#include <gtest/gtest.h>
+
+
+struct GlobPatternTests : ::testing::Test
+{
+    GlobPatternTests() = default;
+    virtual ~GlobPatternTests() = default;
+};
+
+
+TEST_F(GlobPatternTests, MatchLiteral)
+{
+    const traversal::GlobPattern pattern("main.cpp");
+
+    EXPECT_TRUE(pattern.matches("main.cpp"));
+    EXPECT_FALSE(pattern.matches("main.hpp"));
+}
+
+TEST_F(GlobPatternTests, MatchSuffix)
+{
+    const traversal::GlobPattern pattern("*.cpp");
+
+    EXPECT_TRUE(pattern.matches("main.cpp"));
+    EXPECT_TRUE(pattern.matches(".cpp"));
+    EXPECT_FALSE(pattern.matches("main.hpp"));
+    EXPECT_FALSE(pattern.matches("src/main.cpp"));
+}
+
+TEST_F(GlobPatternTests, StarDoesNotMatchSeparator)
+{
+    const traversal::GlobPattern pattern("src/*.cpp");
+
+    EXPECT_TRUE(pattern.matches("src/main.cpp"));
+    EXPECT_FALSE(pattern.matches("src/formatter/Formatter.cpp"));
+}
+
+TEST_F(GlobPatternTests, DoubleStarMatchesAnyNumberOfDirectories)
+{
+    const traversal::GlobPattern pattern("src/**/*.cpp");
+
+    EXPECT_TRUE(pattern.matches("src/main.cpp"));
+    EXPECT_TRUE(pattern.matches("src/formatter/detail/Pass.cpp"));
+    EXPECT_FALSE(pattern.matches("include/main.cpp"));
+}
+
+TEST_F(GlobPatternTests, TrailingDoubleStarMatchesEverythingInside)
+{
+    const traversal::GlobPattern pattern("build/**");
+
+    EXPECT_TRUE(pattern.matches("build/a/b/c.o"));
+    EXPECT_FALSE(pattern.matches("src/a.cpp"));
+}
+
+TEST_F(GlobPatternTests, MatchQuestionMarkAndCharacterClasses)
+{
+    const traversal::GlobPattern pattern("file?.[ch]");
+    const traversal::GlobPattern negated_pattern("file.[!ch]");
+    const traversal::GlobPattern range_pattern("v[0-9].txt");
+
+    EXPECT_TRUE(pattern.matches("file1.c"));
+    EXPECT_TRUE(pattern.matches("fileA.h"));
+    EXPECT_FALSE(pattern.matches("file1.o"));
+    EXPECT_TRUE(negated_pattern.matches("file.o"));
+    EXPECT_FALSE(negated_pattern.matches("file.c"));
+    EXPECT_TRUE(range_pattern.matches("v7.txt"));
+    EXPECT_FALSE(range_pattern.matches("vx.txt"));
+}
+
+TEST_F(GlobPatternTests, MatchEscapedSpecialChars)
+{
+    const traversal::GlobPattern pattern("\\*.txt");
+
+    EXPECT_TRUE(pattern.matches("*.txt"));
+    EXPECT_FALSE(pattern.matches("a.txt"));
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <traversal/IgnoreRules.hpp>
+
+#include <gtest/gtest.h>
+
+using Match = traversal::IgnoreRules::Match;
+
+
+struct IgnoreRulesTests : ::testing::Test
+{
+    IgnoreRulesTests() = default;
+    virtual ~IgnoreRulesTests() = default;
+};
+
+
+TEST_F(IgnoreRulesTests, SkipCommentsAndEmptyLines)
+{
+    const auto rules = traversal::IgnoreRules::parse("# comment\n\n   \n");
+
+    EXPECT_TRUE(rules.empty());
+}
+
+TEST_F(IgnoreRulesTests, MatchFileNameAtAnyDepth)
+{
+    const auto rules = traversal::IgnoreRules::parse("*.o\n");
+
+    EXPECT_EQ(rules.match("a.o", false), Match::Ignored);
+    EXPECT_EQ(rules.match("src/deep/a.o", false), Match::Ignored);
+    EXPECT_EQ(rules.match("src/a.c", false), Match::None);
+}
+
+TEST_F(IgnoreRulesTests, AnchorPatternsContainingSeparator)
+{
+    const auto rules = traversal::IgnoreRules::parse("/generated.c\ndocs/*.c\n");
+
+    EXPECT_EQ(rules.match("generated.c", false), Match::Ignored);
+    EXPECT_EQ(rules.match("src/generated.c", false), Match::None);
+    EXPECT_EQ(rules.match("docs/a.c", false), Match::Ignored);
+    EXPECT_EQ(rules.match("src/docs/a.c", false), Match::None);
+}
+
+TEST_F(IgnoreRulesTests, MatchDirectoryOnlyRulesOnlyForDirectories)
+{
+    const auto rules = traversal::IgnoreRules::parse("build/\n");
+
+    EXPECT_EQ(rules.match("build", true), Match::Ignored);
+    EXPECT_EQ(rules.match("build", false), Match::None);
+}
+
+TEST_F(IgnoreRulesTests, LastMatchingRuleWins)
+{
+    const auto rules = traversal::IgnoreRules::parse("*.c\n!keep.c\n");
+
+    EXPECT_EQ(rules.match("drop.c", false), Match::Ignored);
+    EXPECT_EQ(rules.match("keep.c", false), Match::Included);
+}
+
+TEST_F(IgnoreRulesTests, HandleCrlfIgnoreFiles)
+{
+    const auto rules = traversal::IgnoreRules::parse("*.o\r\n");
+
+    EXPECT_EQ(rules.match("a.o", false), Match::Ignored);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <watch/WatchSession.hpp>
+#include <TestsOptions.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+
+
+struct WatchSessionTests : ::testing::Test
+{
+    WatchSessionTests()
+    {
+        char path_template[] = "/tmp/code-formatter-watch-XXXXXX";
+        root = mkdtemp(path_template);
+    }
+
+    ~WatchSessionTests() override
+    {
+        std::filesystem::remove_all(root);
+    }
+
+    void writeFile(const std::string &content) const
+    {
+        std::ofstream(root / "a.c", std::ios::binary) << content;
+    }
+
+    std::string readFile() const
+    {
+        std::ifstream f(root / "a.c", std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+
+    watch::ChangeEvent event() const
+    {
+        return watch::ChangeEvent{root / "a.c", std::chrono::steady_clock::now()};
+    }
+
+    std::filesystem::path root;
+    config::LocalFileSystem file_system;
+    config::ConfigResolver config_resolver {testsOptions(), file_system};
+};
+
+
+TEST_F(WatchSessionTests, FormatChangedFileInPlace)
+{
+    watch::WatchSession session(config_resolver);
+    writeFile("f() {\r\nx(); y();\r\n}\r\n");
+
+    const auto report = session.handle(event());
+
+    EXPECT_EQ(report.result, watch::EventReport::Result::Formatted);
+    EXPECT_EQ(readFile(), "f() {\r\n    x();\r\n    y();\r\n}\r\n");
+}
+
+TEST_F(WatchSessionTests, SkipEventCausedByOwnWrite)
+{
+    watch::WatchSession session(config_resolver);
+    writeFile("f() {\nx();\n}\n");
+    session.handle(event());
+
+    const auto report = session.handle(event());
+
+    EXPECT_EQ(report.result, watch::EventReport::Result::OwnWrite);
+}
+
+TEST_F(WatchSessionTests, ReportAlreadyFormattedFile)
+{
+    watch::WatchSession session(config_resolver);
+    writeFile("f() {\n    x();\n}\n");
+
+    const auto report = session.handle(event());
+
+    EXPECT_EQ(report.result, watch::EventReport::Result::AlreadyFormatted);
+}
+
+TEST_F(WatchSessionTests, ReformatOnlyEditedLines)
+{
+    watch::WatchSession session(config_resolver);
+    writeFile("f() {\nx();\n}\ng() {\ny();\n}\n");
+    session.handle(event());
+
+    writeFile("f() {\n    x();\n}\ng() {\nz();\n}\n");
+    const auto report = session.handle(event());
+
+    EXPECT_EQ(report.result, watch::EventReport::Result::Formatted);
+    EXPECT_EQ(report.formatted_lines, 1u);
+    EXPECT_EQ(report.total_lines, 6u);
+    EXPECT_EQ(readFile(), "f() {\n    x();\n}\ng() {\n    z();\n}\n");
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023, Adam Chyła <adam@chyla.org>.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <watch/Watcher.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+
+using namespace std::chrono_literals;
+
+
+struct WatcherTests : ::testing::Test
+{
+    WatcherTests()
+    {
+        char path_template[] = "/tmp/code-formatter-watch-XXXXXX";
+        root = mkdtemp(path_template);
+    }
+
+    ~WatcherTests() override
+    {
+        std::filesystem::remove_all(root);
+    }
+
+    void writeFile(const std::filesystem::path &path, const std::string &content = "x\n") const
+    {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    std::filesystem::path root;
+};
+
+
+TEST_F(WatcherTests, ReturnNothingOnTimeout)
+{
+    watch::Watcher watcher;
+    watcher.addPath(root);
+
+    EXPECT_TRUE(watcher.waitForChanges(10ms, 20ms).empty());
+}
+
+TEST_F(WatcherTests, ReportWrittenFileOnceForBurstOfEvents)
+{
+    watch::Watcher watcher;
+    watcher.addPath(root);
+
+    writeFile(root / "a.c");
+    writeFile(root / "a.c");
+    writeFile(root / "a.c");
+
+    const auto events = watcher.waitForChanges(20ms, 1000ms);
+
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events.front().path, root / "a.c");
+}
+
+TEST_F(WatcherTests, ReportFilesInNewSubdirectories)
+{
+    watch::Watcher watcher;
+    watcher.addPath(root);
+
+    std::filesystem::create_directory(root / "sub");
+    watcher.waitForChanges(20ms, 100ms);
+    writeFile(root / "sub" / "b.c");
+
+    const auto events = watcher.waitForChanges(20ms, 1000ms);
+
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events.front().path, root / "sub" / "b.c");
+}
+
+TEST_F(WatcherTests, ReportOnlyWatchedFileOfDirectory)
+{
+    writeFile(root / "a.c");
+    watch::Watcher watcher;
+    watcher.addPath(root / "a.c");
+
+    writeFile(root / "other.c");
+    writeFile(root / "replacement.tmp");
+    std::filesystem::rename(root / "replacement.tmp", root / "a.c");
+
+    const auto events = watcher.waitForChanges(20ms, 1000ms);
+
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events.front().path, root / "a.c");
+}